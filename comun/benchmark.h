@@ -0,0 +1,191 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+// Arnes de medicion compartido por lab01, lab02 y lab04 (C y C++).
+//
+// - Reloj de pared monotono (CLOCK_MONOTONIC): clock() mide tiempo de CPU
+//   del proceso y con varios threads suma el de todos.
+// - Corridas de calentamiento descartadas y repeticiones configurables.
+// - Estadisticas por medicion: mediana, minimo, p95, media y desviacion.
+// - Salida en texto (por defecto) o registros CSV / JSON (uno por linea)
+//   para poder guardar y comparar corridas.
+//
+// Configuracion por entorno:
+//   BENCH_WARMUP=<n>            corridas descartadas (por defecto 1)
+//   BENCH_REPS=<n>              corridas medidas (por defecto 5)
+//   BENCH_FORMATO=texto|csv|json
+//   BENCH_SALIDA=<ruta>         archivo (en modo append) para los registros
+//                               CSV/JSON; por defecto stdout
+//
+// Con BENCH_FORMATO=texto los programas imprimen sus tablas como siempre
+// (usando la mediana); con csv/json ademas se emite un registro por medicion.
+//
+// Requiere enlazar con -lm.
+
+#define BENCH_MAX_NOMBRE 128
+
+enum {
+    BENCH_TEXTO = 0,
+    BENCH_CSV,
+    BENCH_JSON
+};
+
+typedef struct {
+    int calentamiento;
+    int repeticiones;
+    int formato;
+    FILE* salida;
+} bench_config;
+
+typedef struct {
+    char nombre[BENCH_MAX_NOMBRE];
+    int muestras;
+    double mediana;
+    double minimo;
+    double p95;
+    double media;
+    double desviacion;
+} bench_stats;
+
+// Segundos de reloj de pared monotono desde un origen arbitrario
+static inline double bench_ahora(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline int bench_entero_entorno(const char* var, int defecto, int minimo) {
+    const char* v = getenv(var);
+    if (v == NULL || v[0] == '\0') return defecto;
+    int x = (int)strtol(v, NULL, 10);
+    return x < minimo ? minimo : x;
+}
+
+static inline bench_config bench_config_entorno(void) {
+    bench_config cfg;
+    cfg.calentamiento = bench_entero_entorno("BENCH_WARMUP", 1, 0);
+    cfg.repeticiones = bench_entero_entorno("BENCH_REPS", 5, 1);
+    cfg.formato = BENCH_TEXTO;
+    cfg.salida = stdout;
+
+    const char* f = getenv("BENCH_FORMATO");
+    if (f != NULL && strcmp(f, "csv") == 0) cfg.formato = BENCH_CSV;
+    if (f != NULL && strcmp(f, "json") == 0) cfg.formato = BENCH_JSON;
+
+    const char* ruta = getenv("BENCH_SALIDA");
+    if (cfg.formato != BENCH_TEXTO && ruta != NULL && ruta[0] != '\0') {
+        FILE* out = fopen(ruta, "a");
+        if (out != NULL) cfg.salida = out;
+        else fprintf(stderr, "benchmark: no se pudo abrir %s, usando stdout\n", ruta);
+    }
+    return cfg;
+}
+
+static inline void bench_config_cerrar(bench_config* cfg) {
+    if (cfg->salida != NULL && cfg->salida != stdout) fclose(cfg->salida);
+    cfg->salida = stdout;
+}
+
+static inline int bench_comparar(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Estadisticas de n muestras ya tomadas (ordena el arreglo in situ)
+static inline bench_stats bench_estadisticas(const char* nombre, double* muestras, int n) {
+    bench_stats s;
+    memset(&s, 0, sizeof(s));
+    snprintf(s.nombre, sizeof(s.nombre), "%s", nombre);
+    s.muestras = n;
+    if (n <= 0) return s;
+
+    qsort(muestras, n, sizeof(double), bench_comparar);
+    s.minimo = muestras[0];
+    s.mediana = (n % 2) ? muestras[n / 2] : 0.5 * (muestras[n / 2 - 1] + muestras[n / 2]);
+    int i95 = (int)ceil(0.95 * n) - 1;
+    s.p95 = muestras[i95 < 0 ? 0 : i95];
+
+    double suma = 0.0;
+    for (int i = 0; i < n; i++) suma += muestras[i];
+    s.media = suma / n;
+
+    double var = 0.0;
+    for (int i = 0; i < n; i++) var += (muestras[i] - s.media) * (muestras[i] - s.media);
+    s.desviacion = (n > 1) ? sqrt(var / (n - 1)) : 0.0;
+    return s;
+}
+
+// Repite una funcion que toma su propia muestra (prepara, mide y devuelve
+// segundos). Sirve cuando hay que reinicializar datos fuera de la region
+// medida o cuando la medicion la hace otro (p. ej. MPI con barreras).
+static inline bench_stats bench_repetir(const char* nombre, const bench_config* cfg,
+                                        double (*muestra)(void*), void* ctx) {
+    for (int w = 0; w < cfg->calentamiento; w++)
+        muestra(ctx);
+
+    double* t = (double*) malloc(sizeof(double) * cfg->repeticiones);
+    for (int r = 0; r < cfg->repeticiones; r++)
+        t[r] = muestra(ctx);
+
+    bench_stats s = bench_estadisticas(nombre, t, cfg->repeticiones);
+    free(t);
+    return s;
+}
+
+// Mide fn(ctx) con el reloj monotono; preparar (opcional) corre antes de
+// cada repeticion, fuera de la region medida.
+static inline bench_stats bench_medir(const char* nombre, const bench_config* cfg,
+                                      void (*preparar)(void*), void (*fn)(void*), void* ctx) {
+    int total = cfg->calentamiento + cfg->repeticiones;
+    double* t = (double*) malloc(sizeof(double) * cfg->repeticiones);
+
+    for (int r = 0; r < total; r++) {
+        if (preparar != NULL) preparar(ctx);
+        double t0 = bench_ahora();
+        fn(ctx);
+        double t1 = bench_ahora();
+        if (r >= cfg->calentamiento) t[r - cfg->calentamiento] = t1 - t0;
+    }
+
+    bench_stats s = bench_estadisticas(nombre, t, cfg->repeticiones);
+    free(t);
+    return s;
+}
+
+// Emite el registro CSV/JSON de una medicion (no hace nada en modo texto)
+static inline void bench_registrar(const bench_config* cfg, const bench_stats* s) {
+    static int cabecera_csv = 0;
+    FILE* out = cfg->salida ? cfg->salida : stdout;
+
+    if (cfg->formato == BENCH_CSV) {
+        if (!cabecera_csv) {
+            fprintf(out, "nombre,muestras,mediana_s,min_s,p95_s,media_s,desv_s\n");
+            cabecera_csv = 1;
+        }
+        fprintf(out, "%s,%d,%.9f,%.9f,%.9f,%.9f,%.9f\n", s->nombre, s->muestras,
+                s->mediana, s->minimo, s->p95, s->media, s->desviacion);
+    } else if (cfg->formato == BENCH_JSON) {
+        fprintf(out, "{\"nombre\":\"%s\",\"muestras\":%d,\"mediana_s\":%.9f,\"min_s\":%.9f,"
+                "\"p95_s\":%.9f,\"media_s\":%.9f,\"desv_s\":%.9f}\n", s->nombre, s->muestras,
+                s->mediana, s->minimo, s->p95, s->media, s->desviacion);
+    }
+    fflush(out);
+}
+
+// Texto: una linea con las estadisticas; CSV/JSON: el registro
+static inline void bench_reportar(const bench_config* cfg, const bench_stats* s) {
+    if (cfg->formato != BENCH_TEXTO) {
+        bench_registrar(cfg, s);
+        return;
+    }
+    printf("  %s: mediana %f s, min %f s, p95 %f s, desv %f s (%d reps)\n", s->nombre,
+           s->mediana, s->minimo, s->p95, s->desviacion, s->muestras);
+}
+
+#endif
@@ -0,0 +1,239 @@
+#ifndef ROOFLINE_H
+#define ROOFLINE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "benchmark.h"
+
+// Modelo roofline: ubica cada kernel respecto al pico de la maquina.
+//
+// Dos probes caracterizan el host con los mismos hilos que usa el kernel:
+// - ancho de banda sostenido con un triad tipo STREAM (a = b + s*c) sobre
+//   arreglos mucho mas grandes que la LLC; se cuentan 24 bytes por elemento
+//   como en STREAM (sin el write-allocate de a)
+// - pico de doble precision con cadenas de FMA independientes en el vector
+//   mas ancho soportado (AVX-512F, AVX2+FMA o SSE2)
+//
+// Cada kernel declara sus FLOP y sus bytes de trafico compulsorio (cada
+// dato leido o escrito una vez desde memoria); la intensidad aritmetica
+// resultante es una cota superior y el reporte indica si el kernel queda
+// limitado por memoria o por computo y que porcentaje alcanza del techo
+// min(pico, IA * ancho de banda).
+//
+// Configuracion por entorno:
+//   ROOFLINE=0          omite los probes y el reporte
+//   ROOFLINE_MB=<n>     MiB de cada arreglo del triad (por defecto 64)
+
+typedef struct {
+    int hilos;
+    double gbs;        // GB/s sostenidos (triad)
+    double gflops;     // GFLOP/s pico en doble precision
+    const char* isa;   // vector usado por el probe de pico
+    int activo;
+} roofline_maquina;
+
+typedef struct {
+    double* a;
+    double* b;
+    double* c;
+    long n;
+    int repeticiones;   // 0: solo inicializar
+} roofline_triad_arg;
+
+static inline void* roofline_triad_hilo(void* arg) {
+    roofline_triad_arg* t = (roofline_triad_arg*)arg;
+    const double s = 3.0;
+    // primer toque desde el hilo que va a recorrer el tramo
+    if (t->repeticiones == 0) {
+        for (long i = 0; i < t->n; i++) {
+            t->a[i] = 0.0;
+            t->b[i] = 1.0;
+            t->c[i] = 2.0;
+        }
+    }
+    for (int r = 0; r < t->repeticiones; r++)
+        for (long i = 0; i < t->n; i++)
+            t->a[i] = t->b[i] + s * t->c[i];
+    return NULL;
+}
+
+// GB/s del triad con 'hilos' hilos; mejor de varias corridas
+static inline double roofline_medir_ancho(int hilos, long mb) {
+    long n = mb * 1024 * 1024 / (long)sizeof(double);
+    long tramo = (n / hilos + 7) & ~7L;
+    n = tramo * hilos;
+
+    double* a = (double*) aligned_alloc(64, n * sizeof(double));
+    double* b = (double*) aligned_alloc(64, n * sizeof(double));
+    double* c = (double*) aligned_alloc(64, n * sizeof(double));
+    if (a == NULL || b == NULL || c == NULL) {
+        free(a); free(b); free(c);
+        return 0.0;
+    }
+
+    pthread_t* th = (pthread_t*) malloc(sizeof(pthread_t) * hilos);
+    roofline_triad_arg* args = (roofline_triad_arg*) malloc(sizeof(roofline_triad_arg) * hilos);
+    double mejor = 0.0;
+
+    for (int intento = 0; intento < 4; intento++) {
+        // el primer intento solo inicializa (primer toque) y calienta
+        int reps = (intento == 0) ? 0 : 4;
+        double t0 = bench_ahora();
+        for (int h = 0; h < hilos; h++) {
+            args[h].a = a + h * tramo;
+            args[h].b = b + h * tramo;
+            args[h].c = c + h * tramo;
+            args[h].n = tramo;
+            args[h].repeticiones = reps;
+            pthread_create(&th[h], NULL, roofline_triad_hilo, &args[h]);
+        }
+        for (int h = 0; h < hilos; h++)
+            pthread_join(th[h], NULL);
+        double t = bench_ahora() - t0;
+        if (reps == 0) continue;
+
+        double gbs = 24.0 * n * reps / (t * 1e9);
+        if (gbs > mejor) mejor = gbs;
+    }
+
+    free(th);
+    free(args);
+    free(a);
+    free(b);
+    free(c);
+    return mejor;
+}
+
+// Pico de FLOP: 12 acumuladores independientes cubren latencia x puertos FMA
+#define ROOFLINE_ACUM 12
+
+#define ROOFLINE_DEFINIR_PICO(sufijo, atributo, tipo)                            \
+    atributo static inline double roofline_pico_##sufijo(long iters) {          \
+        tipo x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, m, s;            \
+        memset(&m, 0, sizeof(m)); m += 0.999999;                                \
+        memset(&s, 0, sizeof(s)); s += 1e-9;                                    \
+        memset(&x0, 0, sizeof(x0));                                             \
+        x1 = x0 + 1.0; x2 = x0 + 2.0; x3 = x0 + 3.0; x4 = x0 + 4.0;            \
+        x5 = x0 + 5.0; x6 = x0 + 6.0; x7 = x0 + 7.0; x8 = x0 + 8.0;            \
+        x9 = x0 + 9.0; x10 = x0 + 10.0; x11 = x0 + 11.0;                        \
+        for (long it = 0; it < iters; it++) {                                   \
+            x0 = x0 * m + s; x1 = x1 * m + s; x2 = x2 * m + s;                  \
+            x3 = x3 * m + s; x4 = x4 * m + s; x5 = x5 * m + s;                  \
+            x6 = x6 * m + s; x7 = x7 * m + s; x8 = x8 * m + s;                  \
+            x9 = x9 * m + s; x10 = x10 * m + s; x11 = x11 * m + s;              \
+        }                                                                       \
+        tipo t = x0 + x1 + x2 + x3 + x4 + x5 + x6 + x7 + x8 + x9 + x10 + x11;   \
+        double suma = 0.0;                                                      \
+        for (unsigned l = 0; l < sizeof(tipo) / sizeof(double); l++)            \
+            suma += ((double*)&t)[l];                                           \
+        return suma;                                                            \
+    }
+
+typedef double roofline_v2 __attribute__((vector_size(16)));
+typedef double roofline_v4 __attribute__((vector_size(32)));
+typedef double roofline_v8 __attribute__((vector_size(64)));
+
+ROOFLINE_DEFINIR_PICO(sse2, , roofline_v2)
+ROOFLINE_DEFINIR_PICO(avx2, __attribute__((target("avx2,fma"))), roofline_v4)
+ROOFLINE_DEFINIR_PICO(avx512, __attribute__((target("avx512f"))), roofline_v8)
+
+typedef struct {
+    double (*pico)(long);
+    long iters;
+    double sumidero;
+} roofline_pico_arg;
+
+static inline void* roofline_pico_hilo(void* arg) {
+    roofline_pico_arg* p = (roofline_pico_arg*)arg;
+    p->sumidero = p->pico(p->iters);
+    return NULL;
+}
+
+// GFLOP/s pico con 'hilos' hilos
+static inline double roofline_medir_pico(int hilos, const char** isa) {
+    double (*pico)(long) = roofline_pico_sse2;
+    int lanes = 2;
+    *isa = "sse2";
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        pico = roofline_pico_avx512;
+        lanes = 8;
+        *isa = "avx512f";
+    } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        pico = roofline_pico_avx2;
+        lanes = 4;
+        *isa = "avx2+fma";
+    }
+
+    const long iters = 20000000;
+    pthread_t* th = (pthread_t*) malloc(sizeof(pthread_t) * hilos);
+    roofline_pico_arg* args = (roofline_pico_arg*) malloc(sizeof(roofline_pico_arg) * hilos);
+    double mejor = 0.0;
+
+    for (int intento = 0; intento < 3; intento++) {
+        double t0 = bench_ahora();
+        for (int h = 0; h < hilos; h++) {
+            args[h].pico = pico;
+            args[h].iters = iters;
+            pthread_create(&th[h], NULL, roofline_pico_hilo, &args[h]);
+        }
+        for (int h = 0; h < hilos; h++)
+            pthread_join(th[h], NULL);
+        double t = bench_ahora() - t0;
+        double gf = 2.0 * lanes * ROOFLINE_ACUM * (double)iters * hilos / (t * 1e9);
+        if (gf > mejor) mejor = gf;
+    }
+
+    free(th);
+    free(args);
+    return mejor;
+}
+
+static inline roofline_maquina roofline_caracterizar(int hilos) {
+    roofline_maquina m;
+    memset(&m, 0, sizeof(m));
+    m.hilos = hilos < 1 ? 1 : hilos;
+    m.isa = "-";
+
+    const char* v = getenv("ROOFLINE");
+    if (v != NULL && v[0] == '0') return m;
+
+    m.gbs = roofline_medir_ancho(m.hilos, bench_entero_entorno("ROOFLINE_MB", 64, 1));
+    m.gflops = roofline_medir_pico(m.hilos, &m.isa);
+    m.activo = m.gbs > 0.0 && m.gflops > 0.0;
+    return m;
+}
+
+static inline void roofline_imprimir_maquina(const roofline_maquina* m) {
+    if (!m->activo) return;
+    printf("roofline (%d hilo%s): ancho de banda %.2f GB/s, pico %.2f GFLOP/s (%s), "
+           "punto de quiebre IA = %.2f FLOP/byte\n", m->hilos, m->hilos == 1 ? "" : "s",
+           m->gbs, m->gflops, m->isa, m->gflops / m->gbs);
+}
+
+static inline void roofline_cabecera(void) {
+    printf("  %-40s %9s %9s %9s %9s %8s %s\n", "kernel", "IA", "GFLOP/s", "GB/s",
+           "techo", "% techo", "limite");
+}
+
+// Una fila: intensidad aritmetica, rendimiento alcanzado y % del techo.
+// Mas de 100% en un kernel limitado por memoria indica que los datos se
+// reutilizan desde cache entre repeticiones (el techo es el de DRAM)
+static inline void roofline_reportar(const roofline_maquina* m, const char* nombre,
+                                     double flops, double bytes, double segundos) {
+    if (!m->activo || segundos <= 0.0 || bytes <= 0.0) return;
+    double ia = flops / bytes;
+    double gf = flops / (segundos * 1e9);
+    double gbs = bytes / (segundos * 1e9);
+    double techo_mem = ia * m->gbs;
+    double techo = techo_mem < m->gflops ? techo_mem : m->gflops;
+    const char* limite = techo_mem < m->gflops ? (gf > techo ? "memoria (cache)" : "memoria")
+                                               : "computo";
+    printf("  %-40s %9.3f %9.3f %9.3f %9.3f %7.1f%% %s\n", nombre, ia, gf, gbs, techo,
+           100.0 * gf / techo, limite);
+}
+
+#endif
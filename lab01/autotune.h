@@ -0,0 +1,171 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <cpuid.h>
+
+#include "simd.h"
+
+// Autoajuste de tamaños de bloque con cache persistente en disco.
+//
+// Cada entrada de la cache guarda los mejores parametros (hasta 3: block, o
+// mc/kc/nc para gemm) de un kernel para un tamaño n, indexados por la firma
+// de la CPU (fabricante, familia/modelo/stepping, nombre comercial y camino
+// SIMD elegido). Al cambiar de tipo de nodo la firma cambia y las entradas
+// viejas simplemente no se usan.
+//
+// Formato de la cache (una entrada por linea):
+//   <firma> <kernel> <n> <p0> <p1> <p2> <segundos>
+// La ruta se toma de AUTOTUNE_CACHE o, por defecto, autotune_cache.txt.
+
+#define AUTOTUNE_MAX_PARAMS 3
+#define AUTOTUNE_MAX_LINEA 512
+#define AUTOTUNE_REPETICIONES 2
+
+typedef double (*autotune_medida)(int n, const int p[AUTOTUNE_MAX_PARAMS]);
+
+static inline const char* autotune_ruta_cache(void) {
+    const char* ruta = getenv("AUTOTUNE_CACHE");
+    return (ruta != NULL && ruta[0] != '\0') ? ruta : "autotune_cache.txt";
+}
+
+// Firma de la CPU sin espacios, apta para la primera columna de la cache
+static inline void autotune_firma(char* firma, size_t len) {
+    unsigned int eax, ebx, ecx, edx;
+    char fabricante[13] = "desconocido";
+    char marca[49] = "";
+    unsigned int familia = 0, modelo = 0, stepping = 0;
+
+    if (__get_cpuid(0, &eax, &ebx, &ecx, &edx)) {
+        memcpy(fabricante + 0, &ebx, 4);
+        memcpy(fabricante + 4, &edx, 4);
+        memcpy(fabricante + 8, &ecx, 4);
+        fabricante[12] = '\0';
+    }
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        familia = (eax >> 8) & 0xf;
+        modelo = (eax >> 4) & 0xf;
+        stepping = eax & 0xf;
+        if (familia == 0xf) familia += (eax >> 20) & 0xff;
+        if (familia == 0x6 || familia >= 0xf) modelo |= ((eax >> 16) & 0xf) << 4;
+    }
+    if (__get_cpuid_max(0x80000000, NULL) >= 0x80000004) {
+        unsigned int* r = (unsigned int*)marca;
+        for (unsigned int hoja = 0; hoja < 3; hoja++)
+            __get_cpuid(0x80000002 + hoja, &r[4 * hoja], &r[4 * hoja + 1],
+                        &r[4 * hoja + 2], &r[4 * hoja + 3]);
+        marca[48] = '\0';
+    }
+
+    snprintf(firma, len, "%s-%u-%u-%u-%s-%s",
+             fabricante, familia, modelo, stepping, marca, simd_nombre());
+
+    // espacios y caracteres raros -> '_' (la firma es un token de la cache)
+    for (char* c = firma; *c != '\0'; c++)
+        if (!isalnum((unsigned char)*c) && *c != '-' && *c != '+' && *c != '.')
+            *c = '_';
+}
+
+// Busca en la cache los parametros de kernel para n. Si no hay una entrada
+// exacta usa la del n mas cercano de la misma firma. Devuelve 1 si encontro.
+static inline int autotune_buscar(const char* kernel, int n, int p[AUTOTUNE_MAX_PARAMS]) {
+    char firma[256], linea[AUTOTUNE_MAX_LINEA];
+    autotune_firma(firma, sizeof(firma));
+
+    FILE* f = fopen(autotune_ruta_cache(), "r");
+    if (f == NULL) return 0;
+
+    int encontrado = 0, mejor_dist = 0;
+    while (fgets(linea, sizeof(linea), f) != NULL) {
+        char f_firma[256], f_kernel[64];
+        int f_n, q[AUTOTUNE_MAX_PARAMS];
+        double t;
+        if (linea[0] == '#') continue;
+        if (sscanf(linea, "%255s %63s %d %d %d %d %lf", f_firma, f_kernel, &f_n,
+                   &q[0], &q[1], &q[2], &t) != 7)
+            continue;
+        if (strcmp(f_firma, firma) != 0 || strcmp(f_kernel, kernel) != 0) continue;
+
+        int dist = abs(f_n - n);
+        if (!encontrado || dist < mejor_dist) {
+            memcpy(p, q, sizeof(q));
+            mejor_dist = dist;
+            encontrado = 1;
+        }
+    }
+    fclose(f);
+    return encontrado;
+}
+
+// Guarda (o reemplaza) la entrada firma/kernel/n reescribiendo la cache
+static inline int autotune_guardar(const char* kernel, int n,
+                                   const int p[AUTOTUNE_MAX_PARAMS], double segundos) {
+    char firma[256], linea[AUTOTUNE_MAX_LINEA], tmp[1024];
+    const char* ruta = autotune_ruta_cache();
+    autotune_firma(firma, sizeof(firma));
+    snprintf(tmp, sizeof(tmp), "%s.tmp", ruta);
+
+    FILE* out = fopen(tmp, "w");
+    if (out == NULL) return -1;
+    fprintf(out, "# firma kernel n p0 p1 p2 segundos\n");
+
+    FILE* in = fopen(ruta, "r");
+    if (in != NULL) {
+        while (fgets(linea, sizeof(linea), in) != NULL) {
+            char f_firma[256], f_kernel[64];
+            int f_n;
+            if (linea[0] == '#') continue;
+            if (sscanf(linea, "%255s %63s %d", f_firma, f_kernel, &f_n) == 3 &&
+                strcmp(f_firma, firma) == 0 && strcmp(f_kernel, kernel) == 0 && f_n == n)
+                continue;
+            fputs(linea, out);
+        }
+        fclose(in);
+    }
+
+    fprintf(out, "%s %s %d %d %d %d %.6f\n", firma, kernel, n, p[0], p[1], p[2], segundos);
+    fclose(out);
+    return rename(tmp, ruta);
+}
+
+// Minimo de AUTOTUNE_REPETICIONES mediciones (filtra ruido de vecinos)
+static inline double autotune_medir(autotune_medida medida, int n, const int p[AUTOTUNE_MAX_PARAMS]) {
+    double mejor = medida(n, p);
+    for (int r = 1; r < AUTOTUNE_REPETICIONES; r++) {
+        double t = medida(n, p);
+        if (t < mejor) mejor = t;
+    }
+    return mejor;
+}
+
+// Busqueda por coordenadas: ajusta un parametro a la vez (en el orden dado)
+// probando sus candidatos con los demas fijos en el mejor valor actual.
+// mejor[] entra con los valores iniciales y sale con los ganadores.
+static inline double autotune_ajustar(int n, int dims,
+                                      const int* candidatos[AUTOTUNE_MAX_PARAMS],
+                                      const int num_candidatos[AUTOTUNE_MAX_PARAMS],
+                                      autotune_medida medida,
+                                      int mejor[AUTOTUNE_MAX_PARAMS]) {
+    double t_mejor = autotune_medir(medida, n, mejor);
+
+    for (int d = 0; d < dims; d++) {
+        for (int c = 0; c < num_candidatos[d]; c++) {
+            int p[AUTOTUNE_MAX_PARAMS];
+            memcpy(p, mejor, sizeof(p));
+            if (candidatos[d][c] == mejor[d]) continue;
+            p[d] = candidatos[d][c];
+
+            double t = autotune_medir(medida, n, p);
+            if (t < t_mejor) {
+                t_mejor = t;
+                memcpy(mejor, p, sizeof(p));
+            }
+        }
+    }
+    return t_mejor;
+}
+
+#endif
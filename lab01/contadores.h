@@ -0,0 +1,151 @@
+#ifndef CONTADORES_H
+#define CONTADORES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+// Contadores de hardware en proceso via perf_event_open.
+//
+// Reemplaza las corridas de callgrind (simulacion a ~50x) por lecturas de la
+// PMU a velocidad nativa: ciclos, instrucciones, fallos de L1D, fallos de LLC
+// y fallos de dTLB de cada region medida. Cada evento se abre por separado
+// (sin grupo) para que la falta de uno no invalide a los demas; los que
+// falten se reportan como "n/d". Si la PMU no esta disponible en absoluto
+// (perf_event_paranoid, contenedores, VMs sin vPMU) se avisa una vez y el
+// programa sigue igual, sin imprimir contadores.
+// CONTADORES=0 desactiva la instrumentacion.
+
+enum {
+    CONT_CICLOS = 0,
+    CONT_INSTRUCCIONES,
+    CONT_L1D_FALLOS,
+    CONT_LLC_FALLOS,
+    CONT_DTLB_FALLOS,
+    CONT_NUM
+};
+
+typedef struct {
+    int fd[CONT_NUM];
+    uint64_t valor[CONT_NUM];
+    int inicializado;
+} contadores;
+
+static const char* const CONT_NOMBRES[CONT_NUM] = {
+    "ciclos", "instr", "L1D-fallos", "LLC-fallos", "dTLB-fallos"
+};
+
+static inline uint64_t contadores_cache(uint64_t cache, uint64_t op, uint64_t resultado) {
+    return cache | (op << 8) | (resultado << 16);
+}
+
+static inline int contadores_abrir(uint32_t tipo, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = tipo;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // tiempos habilitado/corriendo para escalar si el kernel multiplexa
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+// Abre los eventos del hilo actual. Devuelve cuantos quedaron disponibles.
+static inline int contadores_iniciar(contadores* c) {
+    memset(c, 0, sizeof(*c));
+    for (int e = 0; e < CONT_NUM; e++) c->fd[e] = -1;
+    c->inicializado = 1;
+
+    const char* v = getenv("CONTADORES");
+    if (v != NULL && v[0] == '0') return 0;
+
+    c->fd[CONT_CICLOS] = contadores_abrir(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    c->fd[CONT_INSTRUCCIONES] = contadores_abrir(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    c->fd[CONT_L1D_FALLOS] = contadores_abrir(PERF_TYPE_HW_CACHE,
+        contadores_cache(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+    c->fd[CONT_LLC_FALLOS] = contadores_abrir(PERF_TYPE_HW_CACHE,
+        contadores_cache(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+    c->fd[CONT_DTLB_FALLOS] = contadores_abrir(PERF_TYPE_HW_CACHE,
+        contadores_cache(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS));
+
+    int abiertos = 0;
+    for (int e = 0; e < CONT_NUM; e++)
+        if (c->fd[e] >= 0) abiertos++;
+
+    if (abiertos == 0) {
+        fprintf(stderr, "contadores: perf_event_open no disponible (%s); "
+                "revisar /proc/sys/kernel/perf_event_paranoid\n", strerror(errno));
+    }
+    return abiertos;
+}
+
+static inline void contadores_comenzar(contadores* c) {
+    if (!c->inicializado) contadores_iniciar(c);
+    for (int e = 0; e < CONT_NUM; e++) {
+        if (c->fd[e] < 0) continue;
+        ioctl(c->fd[e], PERF_EVENT_IOC_RESET, 0);
+        ioctl(c->fd[e], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+static inline void contadores_terminar(contadores* c) {
+    for (int e = 0; e < CONT_NUM; e++) {
+        c->valor[e] = 0;
+        if (c->fd[e] < 0) continue;
+        ioctl(c->fd[e], PERF_EVENT_IOC_DISABLE, 0);
+
+        uint64_t lectura[3];  // valor, tiempo habilitado, tiempo corriendo
+        if (read(c->fd[e], lectura, sizeof(lectura)) != (ssize_t)sizeof(lectura))
+            continue;
+        if (lectura[2] > 0 && lectura[2] < lectura[1])
+            c->valor[e] = (uint64_t)((double)lectura[0] * lectura[1] / lectura[2]);
+        else
+            c->valor[e] = lectura[0];
+    }
+}
+
+static inline int contadores_disponible(const contadores* c, int e) {
+    return c->fd[e] >= 0;
+}
+
+static inline int contadores_alguno(const contadores* c) {
+    for (int e = 0; e < CONT_NUM; e++)
+        if (c->fd[e] >= 0) return 1;
+    return 0;
+}
+
+// Una linea con los contadores de la ultima region (y el IPC si se puede);
+// no imprime nada si no se pudo abrir ningun evento
+static inline void contadores_imprimir(const contadores* c, const char* etiqueta) {
+    if (!contadores_alguno(c)) return;
+    printf("  [%s]", etiqueta);
+    for (int e = 0; e < CONT_NUM; e++) {
+        if (contadores_disponible(c, e))
+            printf(" %s=%llu", CONT_NOMBRES[e], (unsigned long long)c->valor[e]);
+        else
+            printf(" %s=n/d", CONT_NOMBRES[e]);
+    }
+    if (contadores_disponible(c, CONT_CICLOS) && contadores_disponible(c, CONT_INSTRUCCIONES) &&
+        c->valor[CONT_CICLOS] > 0)
+        printf(" IPC=%.2f", (double)c->valor[CONT_INSTRUCCIONES] / c->valor[CONT_CICLOS]);
+    printf("\n");
+}
+
+static inline void contadores_cerrar(contadores* c) {
+    for (int e = 0; e < CONT_NUM; e++) {
+        if (c->fd[e] >= 0) close(c->fd[e]);
+        c->fd[e] = -1;
+    }
+    c->inicializado = 0;
+}
+
+#endif
@@ -1,41 +1,127 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 
-#define MAX 5000
+#include "../comun/benchmark.h"
+#include "../comun/roofline.h"
+#include "matriz.h"
+#include "simd.h"
+#include "contadores.h"
 
-double A[MAX][MAX], x[MAX], y[MAX];
+typedef struct {
+    matriz* A;
+    double* x;
+    double* y;
+    int n;
+    const simd_kernels* kern;
+    contadores* cont;
+} problema;
 
-int main() {
+void limpiar_y(void* arg) {
+    problema* p = (problema*)arg;
+    for (int i = 0; i < p->n; i++) p->y[i] = 0.0;
+}
+
+// Primer par de bucles: recorrido por filas
+void bucle_filas(void* arg) {
+    problema* p = (problema*)arg;
+    int n = p->n;
+    contadores_comenzar(p->cont);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            p->y[i] += MAT(p->A, i, j) * p->x[j];
+    contadores_terminar(p->cont);
+}
+
+// Segundo par de bucles: recorrido por columnas
+void bucle_columnas(void* arg) {
+    problema* p = (problema*)arg;
+    int n = p->n;
+    contadores_comenzar(p->cont);
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+            p->y[i] += MAT(p->A, i, j) * p->x[j];
+    contadores_terminar(p->cont);
+}
+
+// Mismo recorrido que el primer par de bucles, con el producto punto vectorial
+void bucle_vectorizado(void* arg) {
+    problema* p = (problema*)arg;
+    contadores_comenzar(p->cont);
+    for (int i = 0; i < p->n; i++)
+        p->y[i] = p->kern->dot(p->n, matriz_fila(p->A, i), p->x);
+    contadores_terminar(p->cont);
+}
+
+// Roofline: 2 FLOP por elemento de A; trafico compulsorio A, x e y una vez
+double flops_matvec(int n) {
+    return 2.0 * n * (double)n;
+}
+
+double bytes_matvec(int n) {
+    return 8.0 * ((double)n * n + 2.0 * n);
+}
+
+// uso: ./enunciado1 [n]   (por defecto n = 5000)
+int main(int argc, char* argv[]) {
     int i, j;
-    clock_t start, end;
-    double cpu_time;
+    int n = matriz_argumento(argc, argv, 1, 5000);
+    int flags = matriz_flags_entorno();
+    bench_config cfg = bench_config_entorno();
+    bench_stats s[3];
+    char nombre[BENCH_MAX_NOMBRE];
+    contadores cont;
+
+    matriz A;
+    if (matriz_crear(&A, n, n, flags) != 0) return 1;
+    double* x = vector_crear(n, flags);
+    double* y = vector_crear(n, flags);
+    if (x == NULL || y == NULL) return 1;
 
-    for (i = 0; i < MAX; i++) {
+    for (i = 0; i < n; i++) {
         x[i] = 1.0;
         y[i] = 0.0;
-        for (j = 0; j < MAX; j++) {
-            A[i][j] = (double)(i + j) / MAX;
+        for (j = 0; j < n; j++) {
+            MAT(&A, i, j) = (double)(i + j) / n;
         }
     }
 
-    start = clock();
-    for (i = 0; i < MAX; i++)
-        for (j = 0; j < MAX; j++)
-            y[i] += A[i][j] * x[j];
-    end = clock();
-    cpu_time = ((double)(end - start)) / CLOCKS_PER_SEC;
-    printf("Tiempo primer par de bucles: %f segundos\n", cpu_time);
+    printf("Matriz %dx%d (ld=%d, hugepages=%s)\n", n, n, A.ld,
+           (flags & MATRIZ_HUGEPAGES) ? "si" : "no");
+    contadores_iniciar(&cont);
 
-    for (i = 0; i < MAX; i++) y[i] = 0.0;
+    problema p = {&A, x, y, n, simd_seleccionar(), &cont};
 
-    start = clock();
-    for (j = 0; j < MAX; j++)
-        for (i = 0; i < MAX; i++)
-            y[i] += A[i][j] * x[j];
-    end = clock();
-    cpu_time = ((double)(end - start)) / CLOCKS_PER_SEC;
-    printf("Tiempo segundo par de bucles: %f segundos\n", cpu_time);
+    snprintf(nombre, sizeof(nombre), "enunciado1/filas/n=%d", n);
+    s[0] = bench_medir(nombre, &cfg, limpiar_y, bucle_filas, &p);
+    printf("Tiempo primer par de bucles: %f segundos\n", s[0].mediana);
+    bench_reportar(&cfg, &s[0]);
+    contadores_imprimir(&cont, "filas");
+
+    snprintf(nombre, sizeof(nombre), "enunciado1/columnas/n=%d", n);
+    s[1] = bench_medir(nombre, &cfg, limpiar_y, bucle_columnas, &p);
+    printf("Tiempo segundo par de bucles: %f segundos\n", s[1].mediana);
+    bench_reportar(&cfg, &s[1]);
+    contadores_imprimir(&cont, "columnas");
+
+    snprintf(nombre, sizeof(nombre), "enunciado1/vectorizado-%s/n=%d", p.kern->nombre, n);
+    s[2] = bench_medir(nombre, &cfg, limpiar_y, bucle_vectorizado, &p);
+    printf("Tiempo bucle vectorizado (%s): %f segundos\n", p.kern->nombre, s[2].mediana);
+    bench_reportar(&cfg, &s[2]);
+    contadores_imprimir(&cont, "vectorizado");
+
+    roofline_maquina maq = roofline_caracterizar(1);
+    if (maq.activo) {
+        printf("\n");
+        roofline_imprimir_maquina(&maq);
+        roofline_cabecera();
+        for (int k = 0; k < 3; k++)
+            roofline_reportar(&maq, s[k].nombre, flops_matvec(n), bytes_matvec(n), s[k].mediana);
+    }
 
+    contadores_cerrar(&cont);
+    bench_config_cerrar(&cfg);
+    matriz_liberar(&A);
+    free(x);
+    free(y);
     return 0;
 }
@@ -1,40 +1,128 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 
-#define MAX 1000
+#include "../comun/benchmark.h"
+#include "../comun/roofline.h"
+#include "matriz.h"
+#include "gemm.h"
+#include "contadores.h"
 
-double A[MAX][MAX], B[MAX][MAX], C[MAX][MAX];
+typedef struct {
+    matriz* A;
+    matriz* B;
+    matriz* C;
+    contadores* cont;
+} problema;
 
-void multiplicacion(int n) {
-    int i, j, k;
-    clock_t start, end;
-    double cpu_time;
-
-    for (i = 0; i < n; i++)
-        for (j = 0; j < n; j++) {
-            A[i][j] = (double)(i + j) / n;
-            B[i][j] = (double)(i - j) / n;
-            C[i][j] = 0.0;
+void inicializar(void* arg) {
+    problema* p = (problema*)arg;
+    int n = p->A->filas;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            MAT(p->A, i, j) = (double)(i + j) / n;
+            MAT(p->B, i, j) = (double)(i - j) / n;
+            MAT(p->C, i, j) = 0.0;
         }
+}
+
+void multiplicacion(void* arg) {
+    problema* p = (problema*)arg;
+    int i, j, k;
+    int n = p->A->filas;
 
-    start = clock();
+    contadores_comenzar(p->cont);
     for (i = 0; i < n; i++)
         for (j = 0; j < n; j++)
             for (k = 0; k < n; k++)
-                C[i][j] += A[i][k] * B[k][j];
-    end = clock();
+                MAT(p->C, i, j) += MAT(p->A, i, k) * MAT(p->B, k, j);
+    contadores_terminar(p->cont);
+}
+
+// Orden i-k-j: la fila k de B se recorre de forma contigua con un axpy vectorial
+void multiplicacion_simd(void* arg) {
+    problema* p = (problema*)arg;
+    int i, k;
+    int n = p->A->filas;
+    const simd_kernels* kern = simd_seleccionar();
+
+    contadores_comenzar(p->cont);
+    for (i = 0; i < n; i++)
+        for (k = 0; k < n; k++)
+            kern->axpy(n, MAT(p->A, i, k), matriz_fila(p->B, k), matriz_fila(p->C, i));
+    contadores_terminar(p->cont);
+}
+
+void multiplicacion_gemm(void* arg) {
+    problema* p = (problema*)arg;
+    int n = p->A->filas;
 
-    cpu_time = ((double)(end - start)) / CLOCKS_PER_SEC;
-    printf("Tiempo multiplicacion clasica (%dx%d): %f segundos\n", n, n, cpu_time);
+    contadores_comenzar(p->cont);
+    gemm(n, n, n, p->A->datos, p->A->ld, p->B->datos, p->B->ld, p->C->datos, p->C->ld);
+    contadores_terminar(p->cont);
 }
 
-int main() {
+// Roofline: 2n^3 FLOP; trafico compulsorio A y B leidas, C leida y escrita
+double flops_matmul(int n) {
+    return 2.0 * n * n * (double)n;
+}
+
+double bytes_matmul(int n) {
+    return 8.0 * 4.0 * n * (double)n;
+}
+
+// uso: ./enunciado2 [n ...]   (por defecto 100 500 1000)
+int main(int argc, char* argv[]) {
     int sizes[] = {100, 500, 1000};
     int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    int flags = matriz_flags_entorno();
+    bench_config cfg = bench_config_entorno();
+    bench_stats s[3];
+    char nombre[BENCH_MAX_NOMBRE];
+    contadores cont;
+
+    if (argc > 1) num_sizes = argc - 1;
+    contadores_iniciar(&cont);
+    roofline_maquina maq = roofline_caracterizar(1);
+    roofline_imprimir_maquina(&maq);
+
+    for (int i = 0; i < num_sizes; i++) {
+        int n = (argc > 1) ? matriz_argumento(argc, argv, i + 1, 100) : sizes[i];
+        matriz A, B, C;
+        if (matriz_crear(&A, n, n, flags) != 0 || matriz_crear(&B, n, n, flags) != 0 ||
+            matriz_crear(&C, n, n, flags) != 0)
+            return 1;
+        problema p = {&A, &B, &C, &cont};
+
+        snprintf(nombre, sizeof(nombre), "enunciado2/clasica/n=%d", n);
+        s[0] = bench_medir(nombre, &cfg, inicializar, multiplicacion, &p);
+        printf("Tiempo multiplicacion clasica (%dx%d): %f segundos\n", n, n, s[0].mediana);
+        bench_reportar(&cfg, &s[0]);
+        contadores_imprimir(&cont, "clasica");
+
+        snprintf(nombre, sizeof(nombre), "enunciado2/simd-%s/n=%d", simd_nombre(), n);
+        s[1] = bench_medir(nombre, &cfg, inicializar, multiplicacion_simd, &p);
+        printf("Tiempo multiplicacion simd    (%dx%d, %s): %f segundos\n", n, n, simd_nombre(), s[1].mediana);
+        bench_reportar(&cfg, &s[1]);
+        contadores_imprimir(&cont, "simd");
+
+        snprintf(nombre, sizeof(nombre), "enunciado2/gemm-%s/n=%d", simd_nombre(), n);
+        s[2] = bench_medir(nombre, &cfg, inicializar, multiplicacion_gemm, &p);
+        printf("Tiempo multiplicacion gemm    (%dx%d, %s): %f segundos\n", n, n, simd_nombre(), s[2].mediana);
+        bench_reportar(&cfg, &s[2]);
+        contadores_imprimir(&cont, "gemm");
+
+        if (maq.activo) {
+            roofline_cabecera();
+            for (int k = 0; k < 3; k++)
+                roofline_reportar(&maq, s[k].nombre, flops_matmul(n), bytes_matmul(n), s[k].mediana);
+        }
 
-    for (int i = 0; i < num_sizes; i++)
-        multiplicacion(sizes[i]);
+        matriz_liberar(&A);
+        matriz_liberar(&B);
+        matriz_liberar(&C);
+    }
 
+    contadores_cerrar(&cont);
+    bench_config_cerrar(&cfg);
     return 0;
 }
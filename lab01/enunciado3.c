@@ -1,25 +1,54 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
+#include <errno.h>
 
-#define MAX 1000
+#include "../comun/benchmark.h"
+#include "matriz.h"
+#include "gemm.h"
+#include "autotune.h"
+#include "contadores.h"
 
-double A[MAX][MAX], B[MAX][MAX], C[MAX][MAX];
+matriz A, B, C;
 
-void multiplicacion_bloques(int n, int block) {
+// contadores de la ultima region medida por tiempo_*()
+contadores cont;
+bench_config cfg;
+
+// Parametros de una medicion repetida por el arnes
+typedef struct {
+    int n;
+    int block;
+    gemm_bloques bl;
+} medicion;
+
+// (Re)reserva A, B y C como n x n; no hace nada si ya tienen ese tamaño
+int reservar(int n) {
+    if (A.datos != NULL && A.filas == n) return 0;
+    int flags = matriz_flags_entorno();
+    matriz_liberar(&A);
+    matriz_liberar(&B);
+    matriz_liberar(&C);
+    if (matriz_crear(&A, n, n, flags) != 0 || matriz_crear(&B, n, n, flags) != 0 ||
+        matriz_crear(&C, n, n, flags) != 0)
+        return -1;
+    return 0;
+}
+
+double tiempo_bloques(int n, int block) {
     int i, j, k, ii, jj, kk;
-    clock_t start, end;
-    double cpu_time;
+    double start, end;
 
     // Inicializar
     for (i = 0; i < n; i++)
         for (j = 0; j < n; j++) {
-            A[i][j] = (double)(i + j) / n;
-            B[i][j] = (double)(i - j) / n;
-            C[i][j] = 0.0;
+            MAT(&A, i, j) = (double)(i + j) / n;
+            MAT(&B, i, j) = (double)(i - j) / n;
+            MAT(&C, i, j) = 0.0;
         }
 
-    start = clock();
+    contadores_comenzar(&cont);
+    start = bench_ahora();
 
     for (ii = 0; ii < n; ii += block)
         for (jj = 0; jj < n; jj += block)
@@ -27,25 +56,263 @@ void multiplicacion_bloques(int n, int block) {
                 for (i = ii; i < ii + block && i < n; i++)
                     for (j = jj; j < jj + block && j < n; j++)
                         for (k = kk; k < kk + block && k < n; k++)
-                            C[i][j] += A[i][k] * B[k][j];
+                            MAT(&C, i, j) += MAT(&A, i, k) * MAT(&B, k, j);
+
+    end = bench_ahora();
+    contadores_terminar(&cont);
+    return end - start;
+}
+
+double muestra_bloques(void* arg) {
+    medicion* m = (medicion*)arg;
+    return tiempo_bloques(m->n, m->block);
+}
+
+void multiplicacion_bloques(int n, int block) {
+    char nombre[BENCH_MAX_NOMBRE];
+    medicion m = {n, block, GEMM_BLOQUES_DEFECTO};
+    snprintf(nombre, sizeof(nombre), "enunciado3/bloques/n=%d/block=%d", n, block);
+    bench_stats s = bench_repetir(nombre, &cfg, muestra_bloques, &m);
+    printf("Tiempo bloques (%dx%d, block=%d): %f segundos\n", n, n, block, s.mediana);
+    bench_reportar(&cfg, &s);
+    contadores_imprimir(&cont, "bloques");
+}
+
+// Mismo recorrido por bloques, con el bucle j interno como axpy vectorial
+double tiempo_bloques_simd(int n, int block) {
+    int i, j, k, ii, jj, kk;
+    double start, end;
+    const simd_kernels* kern = simd_seleccionar();
+
+    for (i = 0; i < n; i++)
+        for (j = 0; j < n; j++) {
+            MAT(&A, i, j) = (double)(i + j) / n;
+            MAT(&B, i, j) = (double)(i - j) / n;
+            MAT(&C, i, j) = 0.0;
+        }
+
+    contadores_comenzar(&cont);
+    start = bench_ahora();
+
+    for (ii = 0; ii < n; ii += block)
+        for (jj = 0; jj < n; jj += block) {
+            int ancho = (jj + block < n) ? block : n - jj;
+            for (kk = 0; kk < n; kk += block)
+                for (i = ii; i < ii + block && i < n; i++)
+                    for (k = kk; k < kk + block && k < n; k++)
+                        kern->axpy(ancho, MAT(&A, i, k), &MAT(&B, k, jj), &MAT(&C, i, jj));
+        }
+
+    end = bench_ahora();
+    contadores_terminar(&cont);
+    return end - start;
+}
+
+double muestra_bloques_simd(void* arg) {
+    medicion* m = (medicion*)arg;
+    return tiempo_bloques_simd(m->n, m->block);
+}
+
+void multiplicacion_bloques_simd(int n, int block) {
+    char nombre[BENCH_MAX_NOMBRE];
+    medicion m = {n, block, GEMM_BLOQUES_DEFECTO};
+    snprintf(nombre, sizeof(nombre), "enunciado3/bloques-simd-%s/n=%d/block=%d", simd_nombre(), n, block);
+    bench_stats s = bench_repetir(nombre, &cfg, muestra_bloques_simd, &m);
+    printf("Tiempo bloques simd (%dx%d, block=%d, %s): %f segundos\n",
+           n, n, block, simd_nombre(), s.mediana);
+    bench_reportar(&cfg, &s);
+    contadores_imprimir(&cont, "bloques simd");
+}
+
+// Misma multiplicacion con el motor empaquetado (bloques MC/KC/NC + microkernel)
+double tiempo_gemm(int n, gemm_bloques bl) {
+    int i, j;
+    double start, end;
+
+    for (i = 0; i < n; i++)
+        for (j = 0; j < n; j++) {
+            MAT(&A, i, j) = (double)(i + j) / n;
+            MAT(&B, i, j) = (double)(i - j) / n;
+            MAT(&C, i, j) = 0.0;
+        }
+
+    contadores_comenzar(&cont);
+    start = bench_ahora();
+    gemm_con_bloques(n, n, n, A.datos, A.ld, B.datos, B.ld, C.datos, C.ld, bl);
+    end = bench_ahora();
+    contadores_terminar(&cont);
+    return end - start;
+}
+
+double muestra_gemm(void* arg) {
+    medicion* m = (medicion*)arg;
+    return tiempo_gemm(m->n, m->bl);
+}
 
-    end = clock();
-    cpu_time = ((double)(end - start)) / CLOCKS_PER_SEC;
-    printf("Tiempo bloques (%dx%d, block=%d): %f segundos\n", n, n, block, cpu_time);
+void multiplicacion_gemm(int n, gemm_bloques bl) {
+    char nombre[BENCH_MAX_NOMBRE];
+    medicion m = {n, 0, bl};
+    snprintf(nombre, sizeof(nombre), "enunciado3/gemm-%s/n=%d/mc=%d/kc=%d/nc=%d",
+             simd_nombre(), n, bl.mc, bl.kc, bl.nc);
+    bench_stats s = bench_repetir(nombre, &cfg, muestra_gemm, &m);
+    printf("Tiempo gemm (%dx%d, mc=%d kc=%d nc=%d, %s): %f segundos\n",
+           n, n, bl.mc, bl.kc, bl.nc, simd_nombre(), s.mediana);
+    bench_reportar(&cfg, &s);
+    contadores_imprimir(&cont, "gemm");
 }
 
-int main() {
-    int sizes[] = {200, 500, 800, 1000};
+//  autoajuste: adaptadores entre los kernels y autotune.h
+
+double medida_bloques(int n, const int p[AUTOTUNE_MAX_PARAMS]) {
+    return tiempo_bloques(n, p[0]);
+}
+
+double medida_bloques_simd(int n, const int p[AUTOTUNE_MAX_PARAMS]) {
+    return tiempo_bloques_simd(n, p[0]);
+}
+
+double medida_gemm(int n, const int p[AUTOTUNE_MAX_PARAMS]) {
+    gemm_bloques bl = {p[0], p[1], p[2]};
+    return tiempo_gemm(n, bl);
+}
+
+// Incluye tamaños que no son potencia de dos: el optimo suele depender de la
+// asociatividad de la cache y del tamaño de n, no solo de la capacidad
+const int cand_block[] = {8, 12, 16, 24, 32, 40, 48, 64, 80, 96, 128, 192, 256};
+const int cand_mc[] = {32, 48, 64, 96, 128, 160, 192, 256};
+const int cand_kc[] = {64, 96, 128, 192, 256, 320, 384, 512};
+const int cand_nc[] = {256, 512, 1024, 2048, 4096};
+
+#define NUM(v) ((int)(sizeof(v) / sizeof((v)[0])))
+
+// block de las variantes por bloques sin ajuste (punto de partida del ajuste)
+#define BLOCK_DEFECTO 32
+
+// Guarda el ajuste en la cache; si falla lo avisa, porque las proximas
+// corridas no lo van a encontrar
+void guardar_ajuste(const char* kernel, int n, const int p[AUTOTUNE_MAX_PARAMS], double t) {
+    if (autotune_guardar(kernel, n, p, t) != 0)
+        fprintf(stderr, "autotune: no se pudo guardar %s (%dx%d) en %s: %s\n",
+                kernel, n, n, autotune_ruta_cache(), strerror(errno));
+}
+
+void autoajustar(int n) {
+    int p[AUTOTUNE_MAX_PARAMS];
+    double t;
+
+    // un solo parametro (block) para las dos variantes por bloques
+    const int* cand1[AUTOTUNE_MAX_PARAMS] = {cand_block, NULL, NULL};
+    int num1[AUTOTUNE_MAX_PARAMS] = {NUM(cand_block), 0, 0};
+
+    p[0] = BLOCK_DEFECTO; p[1] = 0; p[2] = 0;
+    t = autotune_ajustar(n, 1, cand1, num1, medida_bloques, p);
+    guardar_ajuste("bloques", n, p, t);
+    printf("Ajuste bloques      (%dx%d): block=%d (%f segundos)\n", n, n, p[0], t);
+
+    p[0] = BLOCK_DEFECTO; p[1] = 0; p[2] = 0;
+    t = autotune_ajustar(n, 1, cand1, num1, medida_bloques_simd, p);
+    guardar_ajuste("bloques_simd", n, p, t);
+    printf("Ajuste bloques simd (%dx%d): block=%d (%f segundos)\n", n, n, p[0], t);
+
+    // gemm: mc (bloque de A en L2), kc (tira de B en L1) y nc (panel de B en L3)
+    const int* cand3[AUTOTUNE_MAX_PARAMS] = {cand_mc, cand_kc, cand_nc};
+    int num3[AUTOTUNE_MAX_PARAMS] = {NUM(cand_mc), NUM(cand_kc), NUM(cand_nc)};
+    p[0] = GEMM_MC; p[1] = GEMM_KC; p[2] = GEMM_NC;
+    t = autotune_ajustar(n, 3, cand3, num3, medida_gemm, p);
+    guardar_ajuste("gemm", n, p, t);
+    printf("Ajuste gemm         (%dx%d): mc=%d kc=%d nc=%d (%f segundos)\n",
+           n, n, p[0], p[1], p[2], t);
+}
+
+// Ejecuta cada kernel con los parametros guardados en la cache (o los de
+// defecto si esta CPU todavia no se ajusto)
+void ejecutar_ajustado(int n) {
+    int p[AUTOTUNE_MAX_PARAMS];
+
+    if (!autotune_buscar("bloques", n, p)) {
+        printf("Sin ajuste para bloques (%dx%d), block=%d; ajustar con --autotune\n",
+               n, n, BLOCK_DEFECTO);
+        p[0] = BLOCK_DEFECTO;
+    }
+    multiplicacion_bloques(n, p[0]);
+
+    if (!autotune_buscar("bloques_simd", n, p)) {
+        printf("Sin ajuste para bloques simd (%dx%d), block=%d; ajustar con --autotune\n",
+               n, n, BLOCK_DEFECTO);
+        p[0] = BLOCK_DEFECTO;
+    }
+    multiplicacion_bloques_simd(n, p[0]);
+
+    gemm_bloques bl = GEMM_BLOQUES_DEFECTO;
+    if (autotune_buscar("gemm", n, p)) {
+        bl.mc = p[0];
+        bl.kc = p[1];
+        bl.nc = p[2];
+    }
+    multiplicacion_gemm(n, bl);
+}
+
+// uso: ./enunciado3 [--autotune] [n ...]   (por defecto 200 500 800 1000)
+int main(int argc, char* argv[]) {
+    int default_sizes[] = {200, 500, 800, 1000};
     int blocks[] = {16, 32, 64};
-    int num_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    int* sizes = default_sizes;
+    int num_sizes = sizeof(default_sizes) / sizeof(default_sizes[0]);
     int num_blocks = sizeof(blocks) / sizeof(blocks[0]);
+    int autotune = 0;
+    int primero = 1;
+
+    if (argc > 1 && strcmp(argv[1], "--autotune") == 0) {
+        autotune = 1;
+        primero = 2;
+    }
+    if (argc > primero) {
+        num_sizes = argc - primero;
+        sizes = (int*) malloc(num_sizes * sizeof(int));
+        for (int si = 0; si < num_sizes; si++)
+            sizes[si] = matriz_argumento(argc, argv, primero + si, 200);
+    }
+
+    contadores_iniciar(&cont);
+    cfg = bench_config_entorno();
+
+    if (autotune) {
+        char firma[256];
+        autotune_firma(firma, sizeof(firma));
+        printf("Autoajuste para %s (cache: %s)\n", firma, autotune_ruta_cache());
+        for (int si = 0; si < num_sizes; si++) {
+            if (reservar(sizes[si]) != 0) return 1;
+            autoajustar(sizes[si]);
+        }
+        return 0;
+    }
 
     for (int bi = 0; bi < num_blocks; bi++) {
         int block = blocks[bi];
         for (int si = 0; si < num_sizes; si++) {
             int n = sizes[si];
+            if (reservar(n) != 0) return 1;
             multiplicacion_bloques(n, block);
+            multiplicacion_bloques_simd(n, block);
         }
     }
+
+    for (int si = 0; si < num_sizes; si++) {
+        if (reservar(sizes[si]) != 0) return 1;
+        multiplicacion_gemm(sizes[si], GEMM_BLOQUES_DEFECTO);
+    }
+
+    printf("\nParametros ajustados (%s):\n", autotune_ruta_cache());
+    for (int si = 0; si < num_sizes; si++) {
+        if (reservar(sizes[si]) != 0) return 1;
+        ejecutar_ajustado(sizes[si]);
+    }
+
+    contadores_cerrar(&cont);
+    bench_config_cerrar(&cfg);
+    matriz_liberar(&A);
+    matriz_liberar(&B);
+    matriz_liberar(&C);
+    if (sizes != default_sizes) free(sizes);
     return 0;
 }
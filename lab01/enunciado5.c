@@ -1,57 +1,163 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
 
-#define MAX 1000
+#include "../comun/benchmark.h"
+#include "../comun/roofline.h"
+#include "matriz.h"
+#include "gemm.h"
+#include "contadores.h"
 
-double A[MAX][MAX], B[MAX][MAX], C[MAX][MAX];
+matriz A, B, C;
 
-void inicializar(int n) {
+typedef struct {
+    int n;
+    int block;
+    contadores* cont;
+} problema;
+
+void inicializar(void* arg) {
+    int n = ((problema*)arg)->n;
     for (int i = 0; i < n; i++)
         for (int j = 0; j < n; j++) {
-            A[i][j] = (double)(i + j) / n;
-            B[i][j] = (double)(i - j) / n;
-            C[i][j] = 0.0;
+            MAT(&A, i, j) = (double)(i + j) / n;
+            MAT(&B, i, j) = (double)(i - j) / n;
+            MAT(&C, i, j) = 0.0;
         }
 }
 
-void multiplicacion_clasica(int n) {
-    inicializar(n);
+void multiplicacion_clasica(void* arg) {
+    problema* p = (problema*)arg;
+    int n = p->n;
+    contadores_comenzar(p->cont);
     for (int i = 0; i < n; i++)
         for (int j = 0; j < n; j++)
             for (int k = 0; k < n; k++)
-                C[i][j] += A[i][k] * B[k][j];
+                MAT(&C, i, j) += MAT(&A, i, k) * MAT(&B, k, j);
+    contadores_terminar(p->cont);
 }
 
-void multiplicacion_bloques(int n, int block) {
-    inicializar(n);
+void multiplicacion_bloques(void* arg) {
+    problema* p = (problema*)arg;
+    int n = p->n, block = p->block;
+    contadores_comenzar(p->cont);
     for (int ii = 0; ii < n; ii += block)
         for (int jj = 0; jj < n; jj += block)
             for (int kk = 0; kk < n; kk += block)
                 for (int i = ii; i < ii + block && i < n; i++)
                     for (int j = jj; j < jj + block && j < n; j++)
                         for (int k = kk; k < kk + block && k < n; k++)
-                            C[i][j] += A[i][k] * B[k][j];
+                            MAT(&C, i, j) += MAT(&A, i, k) * MAT(&B, k, j);
+    contadores_terminar(p->cont);
+}
+
+void multiplicacion_bloques_simd(void* arg) {
+    problema* p = (problema*)arg;
+    int n = p->n, block = p->block;
+    const simd_kernels* kern = simd_seleccionar();
+    contadores_comenzar(p->cont);
+    for (int ii = 0; ii < n; ii += block)
+        for (int jj = 0; jj < n; jj += block) {
+            int ancho = (jj + block < n) ? block : n - jj;
+            for (int kk = 0; kk < n; kk += block)
+                for (int i = ii; i < ii + block && i < n; i++)
+                    for (int k = kk; k < kk + block && k < n; k++)
+                        kern->axpy(ancho, MAT(&A, i, k), &MAT(&B, k, jj), &MAT(&C, i, jj));
+        }
+    contadores_terminar(p->cont);
 }
 
-int main() {
-    int n = 500;
-    int block = 32;
+void multiplicacion_gemm(void* arg) {
+    problema* p = (problema*)arg;
+    int n = p->n;
+    contadores_comenzar(p->cont);
+    gemm(n, n, n, A.datos, A.ld, B.datos, B.ld, C.datos, C.ld);
+    contadores_terminar(p->cont);
+}
+
+// 2*n^3 operaciones de punto flotante por multiplicacion
+double gflops(int n, double t) {
+    return 2.0 * n * n * (double)n / (t * 1e9);
+}
 
-    clock_t start, end;
-    double t;
+// trafico compulsorio: A y B leidas, C leida y escrita
+double bytes_matmul(int n) {
+    return 8.0 * 4.0 * n * (double)n;
+}
+
+#define NUM_METODOS 4
+
+// uso: ./enunciado5 [n] [block]   (por defecto n = 500, block = 32)
+int main(int argc, char* argv[]) {
+    int n = matriz_argumento(argc, argv, 1, 500);
+    int block = matriz_argumento(argc, argv, 2, 32);
+    int flags = matriz_flags_entorno();
+    bench_config cfg = bench_config_entorno();
+
+    if (matriz_crear(&A, n, n, flags) != 0 || matriz_crear(&B, n, n, flags) != 0 ||
+        matriz_crear(&C, n, n, flags) != 0)
+        return 1;
+
+    const char* nombres[NUM_METODOS] = {"clasica", "bloques", "bloques simd", "gemm"};
+    void (*metodos[NUM_METODOS])(void*) = {
+        multiplicacion_clasica, multiplicacion_bloques, multiplicacion_bloques_simd, multiplicacion_gemm
+    };
+    bench_stats stats[NUM_METODOS];
+    contadores cont, medidas[NUM_METODOS];
+    contadores_iniciar(&cont);
+    problema p = {n, block, &cont};
+
+    // inicializar corre antes de cada repeticion, fuera de la region medida
+    for (int m = 0; m < NUM_METODOS; m++) {
+        char nombre[BENCH_MAX_NOMBRE];
+        snprintf(nombre, sizeof(nombre), "enunciado5/%s/n=%d/block=%d", nombres[m], n, block);
+        stats[m] = bench_medir(nombre, &cfg, inicializar, metodos[m], &p);
+        medidas[m] = cont;
+    }
+
+    printf("Multiplicacion %dx%d (block=%d, isa=%s, mediana de %d reps)\n",
+           n, n, block, simd_nombre(), cfg.repeticiones);
+    printf("%-12s", "");
+    for (int m = 0; m < NUM_METODOS; m++) printf(" %14s", nombres[m]);
+    printf("\n%-12s", "segundos");
+    for (int m = 0; m < NUM_METODOS; m++) printf(" %14f", stats[m].mediana);
+    printf("\n%-12s", "min");
+    for (int m = 0; m < NUM_METODOS; m++) printf(" %14f", stats[m].minimo);
+    printf("\n%-12s", "p95");
+    for (int m = 0; m < NUM_METODOS; m++) printf(" %14f", stats[m].p95);
+    printf("\n%-12s", "GFLOP/s");
+    for (int m = 0; m < NUM_METODOS; m++) printf(" %14.3f", gflops(n, stats[m].mediana));
+    printf("\n");
+
+    // una fila por contador de hardware (n/d si ese evento no esta disponible);
+    // los valores son los de la ultima repeticion
+    for (int e = 0; e < CONT_NUM && contadores_alguno(&cont); e++) {
+        printf("%-12s", CONT_NOMBRES[e]);
+        for (int m = 0; m < NUM_METODOS; m++) {
+            if (contadores_disponible(&medidas[m], e))
+                printf(" %14llu", (unsigned long long)medidas[m].valor[e]);
+            else
+                printf(" %14s", "n/d");
+        }
+        printf("\n");
+    }
 
-    start = clock();
-    multiplicacion_clasica(n);
-    end = clock();
-    t = ((double)(end - start)) / CLOCKS_PER_SEC;
-    printf("Tiempo clasica (%dx%d): %f segundos\n", n, n, t);
+    roofline_maquina maq = roofline_caracterizar(1);
+    if (maq.activo) {
+        printf("\n");
+        roofline_imprimir_maquina(&maq);
+        roofline_cabecera();
+        for (int m = 0; m < NUM_METODOS; m++)
+            roofline_reportar(&maq, nombres[m], 2.0 * n * n * (double)n, bytes_matmul(n),
+                              stats[m].mediana);
+    }
 
-    start = clock();
-    multiplicacion_bloques(n, block);
-    end = clock();
-    t = ((double)(end - start)) / CLOCKS_PER_SEC;
-    printf("Tiempo bloques (%dx%d, block=%d): %f segundos\n", n, n, block, t);
+    for (int m = 0; m < NUM_METODOS; m++)
+        bench_registrar(&cfg, &stats[m]);
 
+    contadores_cerrar(&cont);
+    bench_config_cerrar(&cfg);
+    matriz_liberar(&A);
+    matriz_liberar(&B);
+    matriz_liberar(&C);
     return 0;
 }
@@ -0,0 +1,152 @@
+#define _GNU_SOURCE     // O_DIRECT en flujo.h
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../comun/benchmark.h"
+#include "matriz.h"
+#include "simd.h"
+#include "flujo.h"
+
+// Producto matriz-vector con la matriz en un archivo (flujo.h) contra el
+// mismo producto con la matriz en memoria. "frio" descarta la cache de
+// paginas antes de cada repeticion (lee del disco); "caliente" no.
+
+typedef struct {
+    flujo_archivo* f;
+    matriz* A;          // NULL si la matriz no entra en memoria
+    double* x;
+    double* y;
+    const simd_kernels* kern;
+    int error;
+} problema;
+
+// Mismos valores que enunciado1
+void generar_fila(int i, double* fila, int cols, void* ctx) {
+    int n = *(int*)ctx;
+    for (int j = 0; j < cols; j++)
+        fila[j] = (double)(i + j) / n;
+}
+
+void descartar(void* arg) {
+    flujo_descartar_cache(((problema*)arg)->f);
+}
+
+void matvec_memoria(void* arg) {
+    problema* p = (problema*)arg;
+    for (int i = 0; i < p->A->filas; i++)
+        p->y[i] = p->kern->dot(p->A->cols, matriz_fila(p->A, i), p->x);
+}
+
+void matvec_mmap(void* arg) {
+    problema* p = (problema*)arg;
+    if (flujo_matvec_mmap(p->f, p->x, p->y, p->kern) != 0) p->error = 1;
+}
+
+void matvec_lectura(void* arg) {
+    problema* p = (problema*)arg;
+    if (flujo_matvec_lectura(p->f, p->x, p->y, p->kern) != 0) p->error = 1;
+}
+
+// Maxima diferencia relativa de y contra la referencia
+double diferencia(const double* y, const double* ref, int n) {
+    double d = 0.0;
+    for (int i = 0; i < n; i++) {
+        double e = fabs(y[i] - ref[i]) / (fabs(ref[i]) > 1.0 ? fabs(ref[i]) : 1.0);
+        if (e > d) d = e;
+    }
+    return d;
+}
+
+#define NUM_MODOS 5
+
+// uso: ./flujo [n] [archivo]   (por defecto n = 8000, archivo flujo_matriz.bin)
+// Si el archivo ya existe con otro tamaño se reescribe. FLUJO_PANEL_MB (16)
+// fija el tamaño de panel, FLUJO_DIRECTO=1 usa O_DIRECT en la lectura y
+// FLUJO_MEMORIA=0 omite la version en memoria (matrices que no entran).
+int main(int argc, char* argv[]) {
+    int n = matriz_argumento(argc, argv, 1, 8000);
+    const char* ruta = (argc > 2) ? argv[2] : "flujo_matriz.bin";
+    int panel_mb = bench_entero_entorno("FLUJO_PANEL_MB", 16, 1);
+    int directo = bench_entero_entorno("FLUJO_DIRECTO", 0, 0);
+    int en_memoria = bench_entero_entorno("FLUJO_MEMORIA", 1, 0);
+    bench_config cfg = bench_config_entorno();
+    int flags = matriz_flags_entorno();
+
+    flujo_archivo f;
+    f.fd = -1;
+    if (access(ruta, R_OK) != 0 || flujo_abrir(&f, ruta, panel_mb, directo) != 0 ||
+        f.filas != n || f.cols != n) {
+        flujo_cerrar(&f);
+        printf("Escribiendo %s (%dx%d)...\n", ruta, n, n);
+        if (flujo_escribir(ruta, n, n, generar_fila, &n) != 0 ||
+            flujo_abrir(&f, ruta, panel_mb, directo) != 0)
+            return 1;
+    }
+
+    double* x = vector_crear(n, flags);
+    double* y = vector_crear(n, flags);
+    double* ref = vector_crear(n, flags);
+    if (x == NULL || y == NULL || ref == NULL) return 1;
+    for (int j = 0; j < n; j++) x[j] = 1.0;
+
+    matriz A;
+    problema p = {&f, NULL, x, y, simd_seleccionar(), 0};
+    if (en_memoria && matriz_crear(&A, n, n, flags) == 0) {
+        for (int i = 0; i < n; i++) generar_fila(i, matriz_fila(&A, i), n, &n);
+        p.A = &A;
+    }
+
+    // referencia: una pasada leyendo el archivo, fuera de la medicion
+    if (flujo_matvec_lectura(&f, x, ref, p.kern) != 0) return 1;
+
+    const char* nombres[NUM_MODOS] = {
+        "memoria", "mmap frio", "lectura frio", "mmap caliente", "lectura caliente"
+    };
+    const char* registros[NUM_MODOS] = {
+        "memoria", "mmap_frio", "lectura_frio", "mmap_caliente", "lectura_caliente"
+    };
+    void (*metodos[NUM_MODOS])(void*) = {
+        matvec_memoria, matvec_mmap, matvec_lectura, matvec_mmap, matvec_lectura
+    };
+    void (*preparar[NUM_MODOS])(void*) = {NULL, descartar, descartar, NULL, NULL};
+
+    double gb = f.bytes_datos / 1e9;
+    printf("Matriz %dx%d en %s: %.2f GB, paneles de %d filas (%.1f MiB), O_DIRECT=%s, isa=%s\n",
+           n, n, ruta, gb, f.filas_panel, flujo_bytes_panel(&f) / (1024.0 * 1024.0),
+           f.directo ? "si" : "no", p.kern->nombre);
+    printf("%-18s %10s %9s %11s %10s\n", "modo", "segundos", "GB/s", "vs memoria", "max |dif|");
+
+    double t_memoria = 0.0;
+    char nombre[BENCH_MAX_NOMBRE];
+    for (int m = 0; m < NUM_MODOS; m++) {
+        if (metodos[m] == matvec_memoria && p.A == NULL) {
+            printf("%-18s %10s %9s %11s %10s\n", nombres[m], "-", "-", "-", "-");
+            continue;
+        }
+        // O_DIRECT no pasa por la cache de paginas: caliente seria igual que frio
+        if (f.directo && metodos[m] == matvec_lectura && preparar[m] == NULL) continue;
+
+        snprintf(nombre, sizeof(nombre), "flujo/%s/n=%d/panel=%dMB", registros[m], n, panel_mb);
+        p.error = 0;
+        bench_stats s = bench_medir(nombre, &cfg, preparar[m], metodos[m], &p);
+        if (p.error) return 1;
+        if (m == 0) t_memoria = s.mediana;
+
+        printf("%-18s %10f %9.3f ", nombres[m], s.mediana, gb / s.mediana);
+        if (t_memoria > 0.0) printf("%10.2fx", t_memoria / s.mediana);
+        else printf("%11s", "-");
+        printf(" %10.2e\n", diferencia(y, ref, n));
+        bench_registrar(&cfg, &s);
+    }
+
+    printf("\nGB/s = bytes de la matriz en el archivo / tiempo; vs memoria = tiempo en memoria / tiempo\n");
+    if (p.A != NULL) matriz_liberar(&A);
+    flujo_cerrar(&f);
+    free(x);
+    free(y);
+    free(ref);
+    bench_config_cerrar(&cfg);
+    return 0;
+}
@@ -0,0 +1,299 @@
+#ifndef FLUJO_H
+#define FLUJO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "matriz.h"
+#include "simd.h"
+
+// Producto matriz-vector fuera de nucleo: la matriz vive en un archivo y se
+// consume por paneles de filas, sin tenerla nunca entera en memoria.
+//
+// Formato del archivo: una cabecera de FLUJO_CABECERA bytes y despues las
+// filas row-major con ld = matriz_calcular_ld(cols, 0) (cada fila alineada a
+// 64 bytes); el largo total se redondea a FLUJO_CABECERA para que todas las
+// lecturas puedan ir con O_DIRECT.
+//
+// Dos maneras de recorrerlo:
+// - flujo_matvec_mmap: el archivo mapeado; antes de cada panel se pide el
+//   siguiente con MADV_WILLNEED (read-ahead del kernel) y el ya consumido se
+//   suelta con MADV_DONTNEED para que la memoria residente no crezca.
+// - flujo_matvec_lectura: doble buffer; un thread lector hace pread() del
+//   panel k+1 mientras el llamador calcula el panel k.
+//
+// Las rutinas devuelven 0 o -1 con el motivo en stderr, como matriz_crear().
+// O_DIRECT necesita _GNU_SOURCE definido antes de cualquier #include.
+
+#define FLUJO_MAGIA 0x5654414dU     // "MATV"
+#define FLUJO_CABECERA 4096         // tambien alineacion de buffers y lecturas
+
+typedef struct {
+    uint32_t magia;
+    int32_t filas;
+    int32_t cols;
+    int32_t ld;
+} flujo_cabecera;
+
+typedef struct {
+    int fd;
+    int filas;
+    int cols;
+    int ld;
+    size_t bytes_fila;
+    size_t bytes_datos;     // filas * bytes_fila
+    int filas_panel;
+    int directo;            // abierto con O_DIRECT
+} flujo_archivo;
+
+// Genera la fila i (cols doubles) para flujo_escribir
+typedef void (*flujo_generador)(int i, double* fila, int cols, void* ctx);
+
+static inline size_t flujo_redondear(size_t bytes) {
+    return (bytes + FLUJO_CABECERA - 1) / FLUJO_CABECERA * FLUJO_CABECERA;
+}
+
+// Escribe un archivo filas x cols fila por fila (no hace falta la matriz en RAM)
+static inline int flujo_escribir(const char* ruta, int filas, int cols,
+                                 flujo_generador gen, void* ctx) {
+    int fd = open(ruta, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "flujo: no se pudo crear %s: %s\n", ruta, strerror(errno));
+        return -1;
+    }
+    int ld = matriz_calcular_ld(cols, 0);
+    size_t bytes_fila = (size_t)ld * sizeof(double);
+    char* cab = (char*) calloc(1, FLUJO_CABECERA);
+    double* fila = (double*) calloc(ld, sizeof(double));
+    if (cab == NULL || fila == NULL) {
+        free(cab);
+        free(fila);
+        close(fd);
+        return -1;
+    }
+
+    flujo_cabecera c = {FLUJO_MAGIA, filas, cols, ld};
+    memcpy(cab, &c, sizeof(c));
+    int ok = write(fd, cab, FLUJO_CABECERA) == FLUJO_CABECERA;
+    for (int i = 0; i < filas && ok; i++) {
+        gen(i, fila, cols, ctx);
+        ok = write(fd, fila, bytes_fila) == (ssize_t)bytes_fila;
+    }
+    size_t total = FLUJO_CABECERA + flujo_redondear((size_t)filas * bytes_fila);
+    if (ok) ok = ftruncate(fd, (off_t)total) == 0 && fsync(fd) == 0;
+    if (!ok) fprintf(stderr, "flujo: error escribiendo %s: %s\n", ruta, strerror(errno));
+
+    free(cab);
+    free(fila);
+    close(fd);
+    return ok ? 0 : -1;
+}
+
+// Abre un archivo escrito por flujo_escribir con paneles de ~panel_mb MiB.
+// Con directo != 0 intenta O_DIRECT (sin cache de paginas) y si el sistema
+// de archivos no lo admite sigue sin el.
+static inline int flujo_abrir(flujo_archivo* f, const char* ruta, int panel_mb, int directo) {
+    memset(f, 0, sizeof(*f));
+    f->fd = -1;
+#ifdef O_DIRECT
+    if (directo) {
+        f->fd = open(ruta, O_RDONLY | O_DIRECT);
+        f->directo = f->fd >= 0;
+    }
+#else
+    (void)directo;
+#endif
+    if (f->fd < 0) f->fd = open(ruta, O_RDONLY);
+    if (f->fd < 0) {
+        fprintf(stderr, "flujo: no se pudo abrir %s: %s\n", ruta, strerror(errno));
+        return -1;
+    }
+
+    flujo_cabecera c;
+    void* cab = NULL;
+    if (posix_memalign(&cab, FLUJO_CABECERA, FLUJO_CABECERA) != 0 ||
+        pread(f->fd, cab, FLUJO_CABECERA, 0) != FLUJO_CABECERA) {
+        fprintf(stderr, "flujo: %s: cabecera ilegible\n", ruta);
+        free(cab);
+        close(f->fd);
+        f->fd = -1;
+        return -1;
+    }
+    memcpy(&c, cab, sizeof(c));
+    free(cab);
+    if (c.magia != FLUJO_MAGIA || c.filas <= 0 || c.cols <= 0 || c.ld < c.cols) {
+        fprintf(stderr, "flujo: %s no es una matriz de flujo.h\n", ruta);
+        close(f->fd);
+        f->fd = -1;
+        return -1;
+    }
+
+    f->filas = c.filas;
+    f->cols = c.cols;
+    f->ld = c.ld;
+    f->bytes_fila = (size_t)c.ld * sizeof(double);
+    f->bytes_datos = (size_t)c.filas * f->bytes_fila;
+
+    // filas por panel: multiplo de las que hacen falta para que cada panel
+    // empiece en un multiplo de FLUJO_CABECERA
+    size_t a = f->bytes_fila, b = FLUJO_CABECERA;
+    while (b != 0) { size_t t = a % b; a = b; b = t; }
+    int paso = (int)(FLUJO_CABECERA / a);
+    size_t objetivo = (size_t)(panel_mb > 0 ? panel_mb : 1) * 1024 * 1024 / f->bytes_fila;
+    f->filas_panel = (int)((objetivo + paso - 1) / paso) * paso;
+    if (f->filas_panel < paso) f->filas_panel = paso;
+    return 0;
+}
+
+static inline void flujo_cerrar(flujo_archivo* f) {
+    if (f->fd >= 0) close(f->fd);
+    f->fd = -1;
+}
+
+// Saca el archivo de la cache de paginas para que la proxima pasada lea del disco
+static inline void flujo_descartar_cache(const flujo_archivo* f) {
+    posix_fadvise(f->fd, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+static inline size_t flujo_bytes_panel(const flujo_archivo* f) {
+    return (size_t)f->filas_panel * f->bytes_fila;
+}
+
+// y[i0 .. i0+filas) = panel * x
+static inline void flujo_panel(const double* panel, int filas, const flujo_archivo* f,
+                               const double* x, double* y, const simd_kernels* kern) {
+    for (int i = 0; i < filas; i++)
+        y[i] = kern->dot(f->cols, panel + (size_t)i * f->ld, x);
+}
+
+static inline int flujo_matvec_mmap(const flujo_archivo* f, const double* x, double* y,
+                                    const simd_kernels* kern) {
+    size_t largo = FLUJO_CABECERA + flujo_redondear(f->bytes_datos);
+    char* base = (char*) mmap(NULL, largo, PROT_READ, MAP_SHARED, f->fd, 0);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "flujo: mmap: %s\n", strerror(errno));
+        return -1;
+    }
+    madvise(base, largo, MADV_SEQUENTIAL);
+
+    char* datos = base + FLUJO_CABECERA;
+    size_t bytes_panel = flujo_bytes_panel(f);
+    for (int i0 = 0; i0 < f->filas; i0 += f->filas_panel) {
+        int filas = (f->filas - i0 < f->filas_panel) ? f->filas - i0 : f->filas_panel;
+        char* panel = datos + (size_t)i0 * f->bytes_fila;
+        if (i0 + f->filas_panel < f->filas) {
+            size_t resto = f->bytes_datos - (size_t)(i0 + f->filas_panel) * f->bytes_fila;
+            madvise(panel + bytes_panel, resto < bytes_panel ? flujo_redondear(resto) : bytes_panel,
+                    MADV_WILLNEED);
+        }
+        flujo_panel((const double*)panel, filas, f, x, y + i0, kern);
+        madvise(panel, flujo_redondear((size_t)filas * f->bytes_fila), MADV_DONTNEED);
+    }
+    munmap(base, largo);
+    return 0;
+}
+
+// Doble buffer: estado[b] = filas cargadas en buf[b], 0 si esta libre, -1 si fallo la lectura
+typedef struct {
+    const flujo_archivo* f;
+    double* buf[2];
+    int estado[2];
+    pthread_mutex_t m;
+    pthread_cond_t cambio;
+} flujo_lector;
+
+// pread completo (puede volver con menos bytes de los pedidos)
+static inline int flujo_leer(int fd, void* dst, size_t bytes, off_t desde) {
+    char* p = (char*)dst;
+    while (bytes > 0) {
+        ssize_t r = pread(fd, p, bytes, desde);
+        if (r < 0 && errno == EINTR) continue;
+        if (r <= 0) return -1;
+        p += r;
+        bytes -= (size_t)r;
+        desde += r;
+    }
+    return 0;
+}
+
+static inline void* flujo_hilo_lector(void* arg) {
+    flujo_lector* l = (flujo_lector*)arg;
+    const flujo_archivo* f = l->f;
+    for (int k = 0, i0 = 0; i0 < f->filas; k++, i0 += f->filas_panel) {
+        int b = k % 2;
+        pthread_mutex_lock(&l->m);
+        while (l->estado[b] != 0) pthread_cond_wait(&l->cambio, &l->m);
+        pthread_mutex_unlock(&l->m);
+
+        int filas = (f->filas - i0 < f->filas_panel) ? f->filas - i0 : f->filas_panel;
+        size_t bytes = flujo_redondear((size_t)filas * f->bytes_fila);
+        int ok = flujo_leer(f->fd, l->buf[b], bytes, FLUJO_CABECERA + (off_t)i0 * f->bytes_fila) == 0;
+
+        pthread_mutex_lock(&l->m);
+        l->estado[b] = ok ? filas : -1;
+        pthread_cond_broadcast(&l->cambio);
+        pthread_mutex_unlock(&l->m);
+        if (!ok) break;
+    }
+    return NULL;
+}
+
+static inline int flujo_matvec_lectura(const flujo_archivo* f, const double* x, double* y,
+                                       const simd_kernels* kern) {
+    flujo_lector l;
+    memset(&l, 0, sizeof(l));
+    l.f = f;
+    size_t bytes = flujo_redondear(flujo_bytes_panel(f));
+    l.buf[0] = (double*) aligned_alloc(FLUJO_CABECERA, bytes);
+    l.buf[1] = (double*) aligned_alloc(FLUJO_CABECERA, bytes);
+    if (l.buf[0] == NULL || l.buf[1] == NULL) {
+        free(l.buf[0]);
+        free(l.buf[1]);
+        return -1;
+    }
+    pthread_mutex_init(&l.m, NULL);
+    pthread_cond_init(&l.cambio, NULL);
+
+    pthread_t lector;
+    int res = 0;
+    if (pthread_create(&lector, NULL, flujo_hilo_lector, &l) != 0) {
+        res = -1;
+    } else {
+        for (int k = 0, i0 = 0; i0 < f->filas; k++, i0 += f->filas_panel) {
+            int b = k % 2;
+            pthread_mutex_lock(&l.m);
+            while (l.estado[b] == 0) pthread_cond_wait(&l.cambio, &l.m);
+            int filas = l.estado[b];
+            pthread_mutex_unlock(&l.m);
+            if (filas < 0) {
+                fprintf(stderr, "flujo: error leyendo el panel que empieza en la fila %d\n", i0);
+                res = -1;
+                break;
+            }
+
+            flujo_panel(l.buf[b], filas, f, x, y + i0, kern);
+
+            pthread_mutex_lock(&l.m);
+            l.estado[b] = 0;
+            pthread_cond_broadcast(&l.cambio);
+            pthread_mutex_unlock(&l.m);
+        }
+        pthread_join(lector, NULL);
+    }
+
+    pthread_cond_destroy(&l.cambio);
+    pthread_mutex_destroy(&l.m);
+    free(l.buf[0]);
+    free(l.buf[1]);
+    return res;
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "simd.h"
+
+// Motor GEMM empaquetado: C += A * B con matrices row-major.
+//
+// Jerarquia de bloques (estilo Goto/BLIS):
+//   - NC columnas de B por bloque (el panel empaquetado de B vive en L3)
+//   - KC de profundidad (una tira KC x NR de B cabe en L1)
+//   - MC filas de A por bloque (el bloque empaquetado MC x KC de A vive en L2)
+// Dentro de cada bloque un microkernel MR x NR mantiene el tile de C en
+// registros y recorre los paneles empaquetados de forma contigua. El
+// microkernel se elige en tiempo de ejecucion (ver simd.h).
+
+#define GEMM_MR SIMD_MR
+#define GEMM_NR SIMD_NR
+#define GEMM_MC 128
+#define GEMM_KC 256
+#define GEMM_NC 4096
+
+typedef struct {
+    int mc;
+    int kc;
+    int nc;
+} gemm_bloques;
+
+static const gemm_bloques GEMM_BLOQUES_DEFECTO = {GEMM_MC, GEMM_KC, GEMM_NC};
+
+// Empaqueta un bloque mc x kc de A en micro-paneles de MR filas:
+// Ap[p][k][r] = A[p*MR + r][k], rellenando con ceros el ultimo panel.
+static inline void gemm_empaquetar_a(int mc, int kc, const double* A, int lda, double* Ap) {
+    for (int p = 0; p < mc; p += GEMM_MR) {
+        int mr = (mc - p < GEMM_MR) ? mc - p : GEMM_MR;
+        for (int k = 0; k < kc; k++) {
+            for (int r = 0; r < mr; r++)
+                Ap[r] = A[(size_t)(p + r) * lda + k];
+            for (int r = mr; r < GEMM_MR; r++)
+                Ap[r] = 0.0;
+            Ap += GEMM_MR;
+        }
+    }
+}
+
+// Empaqueta un bloque kc x nc de B en micro-paneles de NR columnas:
+// Bp[q][k][c] = B[k][q*NR + c], rellenando con ceros el ultimo panel.
+static inline void gemm_empaquetar_b(int kc, int nc, const double* B, int ldb, double* Bp) {
+    for (int q = 0; q < nc; q += GEMM_NR) {
+        int nr = (nc - q < GEMM_NR) ? nc - q : GEMM_NR;
+        for (int k = 0; k < kc; k++) {
+            const double* fila = B + (size_t)k * ldb + q;
+            for (int c = 0; c < nr; c++)
+                Bp[c] = fila[c];
+            for (int c = nr; c < GEMM_NR; c++)
+                Bp[c] = 0.0;
+            Bp += GEMM_NR;
+        }
+    }
+}
+
+// Macro-kernel: recorre el bloque empaquetado mc x nc en tiles MR x NR
+static inline void gemm_macrokernel(int mc, int nc, int kc, const double* Ap, const double* Bp,
+                             double* C, int ldc) {
+    const simd_kernels* kern = simd_seleccionar();
+    for (int j = 0; j < nc; j += GEMM_NR) {
+        int nr = (nc - j < GEMM_NR) ? nc - j : GEMM_NR;
+        const double* panel_b = Bp + (size_t)j * kc;
+        for (int i = 0; i < mc; i += GEMM_MR) {
+            int mr = (mc - i < GEMM_MR) ? mc - i : GEMM_MR;
+            kern->microkernel(kc, Ap + (size_t)i * kc, panel_b,
+                              C + (size_t)i * ldc + j, ldc, mr, nr);
+        }
+    }
+}
+
+// Redondea los bloques a multiplos del microkernel (y aplica los valores
+// por defecto a los que no sean positivos)
+static inline gemm_bloques gemm_normalizar(gemm_bloques bl) {
+    gemm_bloques r;
+    r.mc = ((bl.mc + GEMM_MR - 1) / GEMM_MR) * GEMM_MR;
+    r.nc = ((bl.nc + GEMM_NR - 1) / GEMM_NR) * GEMM_NR;
+    r.kc = bl.kc > 0 ? bl.kc : GEMM_KC;
+    if (r.mc <= 0) r.mc = GEMM_MC;
+    if (r.nc <= 0) r.nc = GEMM_NC;
+    return r;
+}
+
+// Bytes de los buffers de empaquetado de A y B para bloques ya normalizados
+static inline size_t gemm_bytes_a(gemm_bloques bl) {
+    return ((sizeof(double) * (size_t)bl.mc * bl.kc + 63) / 64) * 64;
+}
+
+static inline size_t gemm_bytes_b(gemm_bloques bl) {
+    return ((sizeof(double) * (size_t)bl.nc * bl.kc + 63) / 64) * 64;
+}
+
+// C (m x n) += A (m x k) * B (k x n) con buffers de empaquetado del llamador
+// (alineados a 64 bytes, de gemm_bytes_a / gemm_bytes_b bytes); para quien
+// llama a gemm muchas veces, como las hojas de strassen.h
+static inline void gemm_con_buffers(int m, int n, int k,
+                             const double* A, int lda,
+                             const double* B, int ldb,
+                             double* C, int ldc,
+                             gemm_bloques bl, double* Ap, double* Bp) {
+    if (m <= 0 || n <= 0 || k <= 0) return;
+    int mc = bl.mc, nc = bl.nc, kc = bl.kc;
+
+    for (int jc = 0; jc < n; jc += nc) {
+        int nb = (n - jc < nc) ? n - jc : nc;
+        for (int pc = 0; pc < k; pc += kc) {
+            int kb = (k - pc < kc) ? k - pc : kc;
+            gemm_empaquetar_b(kb, nb, B + (size_t)pc * ldb + jc, ldb, Bp);
+            for (int ic = 0; ic < m; ic += mc) {
+                int mb = (m - ic < mc) ? m - ic : mc;
+                gemm_empaquetar_a(mb, kb, A + (size_t)ic * lda + pc, lda, Ap);
+                gemm_macrokernel(mb, nb, kb, Ap, Bp, C + (size_t)ic * ldc + jc, ldc);
+            }
+        }
+    }
+}
+
+// C (m x n) += A (m x k) * B (k x n) con tamaños de bloque explicitos.
+// Devuelve 0 si todo fue bien y -1 si no se pudieron reservar los buffers.
+static inline int gemm_con_bloques(int m, int n, int k,
+                            const double* A, int lda,
+                            const double* B, int ldb,
+                            double* C, int ldc,
+                            gemm_bloques bl) {
+    if (m <= 0 || n <= 0 || k <= 0) return 0;
+
+    bl = gemm_normalizar(bl);
+    double* Ap = (double*) aligned_alloc(64, gemm_bytes_a(bl));
+    double* Bp = (double*) aligned_alloc(64, gemm_bytes_b(bl));
+    if (Ap == NULL || Bp == NULL) {
+        free(Ap);
+        free(Bp);
+        return -1;
+    }
+
+    gemm_con_buffers(m, n, k, A, lda, B, ldb, C, ldc, bl, Ap, Bp);
+
+    free(Ap);
+    free(Bp);
+    return 0;
+}
+
+// C (m x n) += A (m x k) * B (k x n), todas row-major con su leading dimension
+static inline int gemm(int m, int n, int k,
+                const double* A, int lda,
+                const double* B, int ldb,
+                double* C, int ldc) {
+    return gemm_con_bloques(m, n, k, A, lda, B, ldb, C, ldc, GEMM_BLOQUES_DEFECTO);
+}
+
+#endif
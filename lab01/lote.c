@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../comun/benchmark.h"
+#include "simd.h"
+#include "lote.h"
+
+// Muchas multiplicaciones pequeñas: el lote intercalado de lote.h contra
+// llamar una por una a la version por bloques de enunciado3 (escalar y con
+// axpy vectorial) sobre matrices row-major contiguas.
+
+typedef struct {
+    int s;
+    int cuenta;
+    double *A, *B, *C;    // cuenta matrices s x s row-major, una detras de otra
+    lote La, Lb, Lc;
+} problema;
+
+void inicializar(problema* p) {
+    size_t ss = (size_t)p->s * p->s;
+    for (int b = 0; b < p->cuenta; b++)
+        for (int i = 0; i < p->s; i++)
+            for (int j = 0; j < p->s; j++) {
+                p->A[b * ss + i * p->s + j] = (double)(i + j + b % 7) / p->s;
+                p->B[b * ss + i * p->s + j] = (double)(i - j + b % 5) / p->s;
+            }
+    for (int b = 0; b < p->cuenta; b++) {
+        lote_empaquetar(&p->La, b, p->A + b * ss, p->s);
+        lote_empaquetar(&p->Lb, b, p->B + b * ss, p->s);
+    }
+}
+
+void limpiar_c(void* arg) {
+    problema* p = (problema*)arg;
+    memset(p->C, 0, (size_t)p->cuenta * p->s * p->s * sizeof(double));
+}
+
+void limpiar_lote(void* arg) {
+    problema* p = (problema*)arg;
+    memset(p->Lc.datos, 0, p->Lc.bytes);
+}
+
+// Una matriz por llamada, mismo recorrido que tiempo_bloques de enunciado3
+static void bloques(int n, int block, const double* A, const double* B, double* C) {
+    for (int ii = 0; ii < n; ii += block)
+        for (int jj = 0; jj < n; jj += block)
+            for (int kk = 0; kk < n; kk += block)
+                for (int i = ii; i < ii + block && i < n; i++)
+                    for (int j = jj; j < jj + block && j < n; j++)
+                        for (int k = kk; k < kk + block && k < n; k++)
+                            C[i * n + j] += A[i * n + k] * B[k * n + j];
+}
+
+static void bloques_simd(int n, int block, const double* A, const double* B, double* C,
+                         const simd_kernels* kern) {
+    for (int ii = 0; ii < n; ii += block)
+        for (int jj = 0; jj < n; jj += block) {
+            int ancho = (jj + block < n) ? block : n - jj;
+            for (int kk = 0; kk < n; kk += block)
+                for (int i = ii; i < ii + block && i < n; i++)
+                    for (int k = kk; k < kk + block && k < n; k++)
+                        kern->axpy(ancho, A[i * n + k], B + k * n + jj, C + i * n + jj);
+        }
+}
+
+void multiplicacion_bloques(void* arg) {
+    problema* p = (problema*)arg;
+    size_t ss = (size_t)p->s * p->s;
+    for (int b = 0; b < p->cuenta; b++)
+        bloques(p->s, 32, p->A + b * ss, p->B + b * ss, p->C + b * ss);
+}
+
+void multiplicacion_bloques_simd(void* arg) {
+    problema* p = (problema*)arg;
+    size_t ss = (size_t)p->s * p->s;
+    const simd_kernels* kern = simd_seleccionar();
+    for (int b = 0; b < p->cuenta; b++)
+        bloques_simd(p->s, 32, p->A + b * ss, p->B + b * ss, p->C + b * ss, kern);
+}
+
+void multiplicacion_lote(void* arg) {
+    problema* p = (problema*)arg;
+    lote_multiplicar(&p->La, &p->Lb, &p->Lc);
+}
+
+// Maxima diferencia entre el lote y las matrices row-major de C
+double diferencia(const problema* p) {
+    size_t ss = (size_t)p->s * p->s;
+    double d = 0.0;
+    for (int b = 0; b < p->cuenta; b++)
+        for (int i = 0; i < p->s; i++)
+            for (int j = 0; j < p->s; j++) {
+                double e = *lote_elemento(&p->Lc, b, i, j) - p->C[b * ss + i * p->s + j];
+                if (e < 0) e = -e;
+                if (e > d) d = e;
+            }
+    return d;
+}
+
+#define NUM_METODOS 3
+
+// uso: ./lote [s ...]   (por defecto 4 8 12 16 24 32)
+// LOTE_CUENTA fija la cantidad de matrices; por defecto unos 64 MB por operando
+int main(int argc, char* argv[]) {
+    int default_sizes[] = {4, 8, 12, 16, 24, 32};
+    int num_sizes = (argc > 1) ? argc - 1 : (int)(sizeof(default_sizes) / sizeof(default_sizes[0]));
+    int cuenta_fija = bench_entero_entorno("LOTE_CUENTA", 0, 0);
+    bench_config cfg = bench_config_entorno();
+
+    const char* nombres[NUM_METODOS] = {"bloques", "bloques_simd", "lote"};
+    void (*metodos[NUM_METODOS])(void*) = {
+        multiplicacion_bloques, multiplicacion_bloques_simd, multiplicacion_lote
+    };
+    void (*preparar[NUM_METODOS])(void*) = {limpiar_c, limpiar_c, limpiar_lote};
+
+    printf("Multiplicacion por lotes de matrices pequeñas (isa=%s, %d matrices por paquete, "
+           "mediana de %d reps)\n", simd_nombre(), LOTE_ANCHO, cfg.repeticiones);
+    printf("%4s %8s %-8s | %-13s %10s %12s %9s %8s %10s\n", "s", "cuenta", "kernel", "metodo",
+           "segundos", "ns/matriz", "GFLOP/s", "speedup", "max |dif|");
+
+    for (int si = 0; si < num_sizes; si++) {
+        int s = (argc > 1) ? atoi(argv[si + 1]) : default_sizes[si];
+        if (s <= 0 || s > 32) {
+            fprintf(stderr, "lote: s = %d fuera de rango (1..32), se omite\n", s);
+            continue;
+        }
+        problema p;
+        memset(&p, 0, sizeof(p));
+        p.s = s;
+        p.cuenta = cuenta_fija > 0 ? cuenta_fija : (8 << 20) / (s * s);
+        if (p.cuenta > 100000) p.cuenta = 100000;
+
+        size_t bytes = (size_t)p.cuenta * s * s * sizeof(double);
+        p.A = (double*) malloc(bytes);
+        p.B = (double*) malloc(bytes);
+        p.C = (double*) malloc(bytes);
+        if (p.A == NULL || p.B == NULL || p.C == NULL || lote_crear(&p.La, s, p.cuenta) != 0 ||
+            lote_crear(&p.Lb, s, p.cuenta) != 0 || lote_crear(&p.Lc, s, p.cuenta) != 0)
+            return 1;
+        inicializar(&p);
+
+        int especializado;
+        lote_seleccionar(s, &especializado);
+        double flops = 2.0 * s * s * (double)s * p.cuenta;
+        bench_stats st[NUM_METODOS];
+        char nombre[BENCH_MAX_NOMBRE];
+
+        for (int m = 0; m < NUM_METODOS; m++) {
+            snprintf(nombre, sizeof(nombre), "lote/%s/s=%d/cuenta=%d", nombres[m], s, p.cuenta);
+            st[m] = bench_medir(nombre, &cfg, preparar[m], metodos[m], &p);
+        }
+        // C quedo con el resultado de bloques_simd y Lc con el del lote
+        double dif = diferencia(&p);
+
+        for (int m = 0; m < NUM_METODOS; m++) {
+            printf("%4d %8d %-8s | %-13s %10f %12.1f %9.3f %8.2f ", s, p.cuenta,
+                   especializado ? "fijo" : "generico", nombres[m], st[m].mediana,
+                   st[m].mediana * 1e9 / p.cuenta, flops / (st[m].mediana * 1e9),
+                   st[0].mediana / st[m].mediana);
+            if (m == NUM_METODOS - 1) printf("%10.2e\n", dif);
+            else printf("%10s\n", "");
+            bench_registrar(&cfg, &st[m]);
+        }
+
+        free(p.A);
+        free(p.B);
+        free(p.C);
+        lote_liberar(&p.La);
+        lote_liberar(&p.Lb);
+        lote_liberar(&p.Lc);
+    }
+
+    printf("\nkernel: fijo = s desenrollado en tiempo de compilacion (4, 8, 16, 32), generico = s variable\n"
+           "speedup respecto de bloques (block = 32, una llamada por matriz)\n");
+    bench_config_cerrar(&cfg);
+    return 0;
+}
@@ -0,0 +1,160 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "simd.h"
+
+// Multiplicacion por lotes de matrices pequeñas (4x4 a 32x32).
+//
+// Con matrices tan chicas el costo de multiplicacion_bloques() lo dominan
+// los bucles y las comparaciones de borde, no las FMA. Aca un solo llamado
+// multiplica un lote entero y el layout es intercalado: LOTE_ANCHO matrices
+// consecutivas forman un paquete y el elemento (i, j) de las LOTE_ANCHO
+// matrices del paquete queda contiguo. Asi un vector SIMD corre a lo ancho
+// de las matrices (una lane por matriz) y no hay bordes que tratar dentro
+// de una matriz:
+//
+//   datos[((paquete * s + i) * s + j) * LOTE_ANCHO + lane]
+//
+// Los kernels para s = 4, 8, 16 y 32 se generan con s constante en tiempo
+// de compilacion (bucles internos totalmente desenrollados) para cada ISA;
+// cualquier otro s usa la version generica. El kernel se elige con la misma
+// deteccion de simd.h.
+
+#define LOTE_ANCHO 8   // matrices por paquete = doubles en un vector de 64 bytes
+
+typedef double lote_vector __attribute__((vector_size(LOTE_ANCHO * sizeof(double))));
+
+typedef struct {
+    int s;           // lado de cada matriz
+    int cuenta;      // matrices en el lote
+    int paquetes;    // ceil(cuenta / LOTE_ANCHO); las lanes sobrantes quedan en cero
+    size_t bytes;
+    double* datos;
+} lote;
+
+// C += A * B para 'paquetes' paquetes de matrices s x s
+typedef void (*lote_kernel)(int s, int paquetes, const double* A, const double* B, double* C);
+
+static inline int lote_crear(lote* l, int s, int cuenta) {
+    l->s = s;
+    l->cuenta = cuenta;
+    l->paquetes = (cuenta + LOTE_ANCHO - 1) / LOTE_ANCHO;
+    l->bytes = (size_t)l->paquetes * s * s * LOTE_ANCHO * sizeof(double);
+    l->datos = (double*) aligned_alloc(64, l->bytes > 0 ? l->bytes : 64);
+    if (l->datos == NULL) return -1;
+    memset(l->datos, 0, l->bytes);
+    return 0;
+}
+
+static inline void lote_liberar(lote* l) {
+    free(l->datos);
+    l->datos = NULL;
+}
+
+static inline double* lote_elemento(const lote* l, int b, int i, int j) {
+    size_t paquete = b / LOTE_ANCHO;
+    return l->datos + ((paquete * l->s + i) * l->s + j) * LOTE_ANCHO + b % LOTE_ANCHO;
+}
+
+// Copia la matriz b del lote desde / hacia una matriz row-major con ld
+static inline void lote_empaquetar(lote* l, int b, const double* M, int ld) {
+    for (int i = 0; i < l->s; i++)
+        for (int j = 0; j < l->s; j++)
+            *lote_elemento(l, b, i, j) = M[(size_t)i * ld + j];
+}
+
+static inline void lote_desempaquetar(const lote* l, int b, double* M, int ld) {
+    for (int i = 0; i < l->s; i++)
+        for (int j = 0; j < l->s; j++)
+            M[(size_t)i * ld + j] = *lote_elemento(l, b, i, j);
+}
+
+// Cuerpo comun: una fila de C (S vectores) en registros mientras se recorre
+// la fila de A y las filas de B del paquete
+#define LOTE_CUERPO(S)                                                          \
+    for (int q = 0; q < paquetes; q++) {                                        \
+        const lote_vector* a = (const lote_vector*)A + (size_t)q * (S) * (S);   \
+        const lote_vector* b = (const lote_vector*)B + (size_t)q * (S) * (S);   \
+        lote_vector* c = (lote_vector*)C + (size_t)q * (S) * (S);               \
+        for (int i = 0; i < (S); i++) {                                         \
+            lote_vector fila[32];                                               \
+            _Pragma("GCC unroll 32")                                            \
+            for (int j = 0; j < (S); j++) fila[j] = c[i * (S) + j];             \
+            for (int p = 0; p < (S); p++) {                                     \
+                lote_vector aip = a[i * (S) + p];                               \
+                _Pragma("GCC unroll 32")                                        \
+                for (int j = 0; j < (S); j++) fila[j] += aip * b[p * (S) + j];  \
+            }                                                                   \
+            _Pragma("GCC unroll 32")                                            \
+            for (int j = 0; j < (S); j++) c[i * (S) + j] = fila[j];             \
+        }                                                                       \
+    }
+
+// Kernel generico: s en tiempo de ejecucion, sin desenrollar
+#define LOTE_CUERPO_GENERICO                                                    \
+    for (int q = 0; q < paquetes; q++) {                                        \
+        const lote_vector* a = (const lote_vector*)A + (size_t)q * s * s;       \
+        const lote_vector* b = (const lote_vector*)B + (size_t)q * s * s;       \
+        lote_vector* c = (lote_vector*)C + (size_t)q * s * s;                   \
+        for (int i = 0; i < s; i++)                                             \
+            for (int p = 0; p < s; p++) {                                       \
+                lote_vector aip = a[i * s + p];                                 \
+                for (int j = 0; j < s; j++) c[i * s + j] += aip * b[p * s + j]; \
+            }                                                                   \
+    }
+
+#define LOTE_DEFINIR_KERNELS(sufijo, atributo)                                  \
+    atributo static void lote_kernel_4_##sufijo(int s, int paquetes,            \
+            const double* A, const double* B, double* C) {                      \
+        (void)s; LOTE_CUERPO(4)                                                 \
+    }                                                                           \
+    atributo static void lote_kernel_8_##sufijo(int s, int paquetes,            \
+            const double* A, const double* B, double* C) {                      \
+        (void)s; LOTE_CUERPO(8)                                                 \
+    }                                                                           \
+    atributo static void lote_kernel_16_##sufijo(int s, int paquetes,           \
+            const double* A, const double* B, double* C) {                      \
+        (void)s; LOTE_CUERPO(16)                                                \
+    }                                                                           \
+    atributo static void lote_kernel_32_##sufijo(int s, int paquetes,           \
+            const double* A, const double* B, double* C) {                      \
+        (void)s; LOTE_CUERPO(32)                                                \
+    }                                                                           \
+    atributo static void lote_kernel_n_##sufijo(int s, int paquetes,            \
+            const double* A, const double* B, double* C) {                      \
+        LOTE_CUERPO_GENERICO                                                    \
+    }
+
+LOTE_DEFINIR_KERNELS(sse2, )
+LOTE_DEFINIR_KERNELS(avx2, __attribute__((target("avx2,fma"))))
+LOTE_DEFINIR_KERNELS(avx512, __attribute__((target("avx512f"))))
+
+// Kernel para lado s con la ISA de simd_seleccionar(); *especializado
+// (si no es NULL) indica si s tiene version desenrollada
+static inline lote_kernel lote_seleccionar(int s, int* especializado) {
+    static const lote_kernel tabla[3][5] = {
+        {lote_kernel_4_sse2, lote_kernel_8_sse2, lote_kernel_16_sse2, lote_kernel_32_sse2, lote_kernel_n_sse2},
+        {lote_kernel_4_avx2, lote_kernel_8_avx2, lote_kernel_16_avx2, lote_kernel_32_avx2, lote_kernel_n_avx2},
+        {lote_kernel_4_avx512, lote_kernel_8_avx512, lote_kernel_16_avx512, lote_kernel_32_avx512,
+         lote_kernel_n_avx512},
+    };
+    simd_isa isa = simd_seleccionar()->isa;
+    int fila = (isa == ISA_AVX512) ? 2 : (isa == ISA_AVX2) ? 1 : 0;
+    int columna = (s == 4) ? 0 : (s == 8) ? 1 : (s == 16) ? 2 : (s == 32) ? 3 : 4;
+    if (especializado != NULL) *especializado = columna < 4;
+    return tabla[fila][columna];
+}
+
+// C[b] += A[b] * B[b] para cada matriz del lote. Devuelve -1 si los lotes
+// no tienen el mismo lado y la misma cantidad de matrices.
+static inline int lote_multiplicar(const lote* A, const lote* B, lote* C) {
+    if (A->s != B->s || A->s != C->s || A->cuenta != B->cuenta || A->cuenta != C->cuenta)
+        return -1;
+    lote_seleccionar(A->s, NULL)(A->s, A->paquetes, A->datos, B->datos, C->datos);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef MATRIZ_H
+#define MATRIZ_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// Matriz densa row-major con dimensiones en tiempo de ejecucion.
+//
+// - Los datos empiezan alineados a 64 bytes (una linea de cache) y cada fila
+//   tambien, porque ld se redondea a multiplos de 8 doubles.
+// - Con MATRIZ_RELLENO, si el paso entre filas es multiplo de 1 KiB se le
+//   suma una linea de cache para que las filas consecutivas no caigan en el
+//   mismo conjunto de la cache (n = 512, 1024, 2048, ...).
+// - Con MATRIZ_HUGEPAGES las reservas grandes se alinean a 2 MiB y se marcan
+//   con madvise(MADV_HUGEPAGE) para que el kernel las respalde con paginas
+//   enormes transparentes (menos fallos de TLB en n = 5000 o mas).
+//
+// Las variables de entorno MATRIZ_RELLENO=0|1 (por defecto 1) y
+// MATRIZ_HUGEPAGES=0|1 (por defecto 0) controlan las opciones de
+// matriz_flags_entorno().
+
+#define MATRIZ_ALINEACION 64
+#define MATRIZ_PAGINA_ENORME (2u * 1024 * 1024)
+
+enum {
+    MATRIZ_RELLENO = 1,
+    MATRIZ_HUGEPAGES = 2
+};
+
+typedef struct {
+    int filas;
+    int cols;
+    int ld;         // elementos entre el inicio de dos filas (cols + relleno)
+    int flags;
+    size_t bytes;
+    double* datos;
+} matriz;
+
+// Acceso al elemento (i, j)
+#define MAT(m, i, j) ((m)->datos[(size_t)(i) * (m)->ld + (j)])
+
+static inline int matriz_flags_entorno(void) {
+    int flags = MATRIZ_RELLENO;
+    const char* v = getenv("MATRIZ_RELLENO");
+    if (v != NULL && v[0] == '0') flags &= ~MATRIZ_RELLENO;
+    v = getenv("MATRIZ_HUGEPAGES");
+    if (v != NULL && v[0] == '1') flags |= MATRIZ_HUGEPAGES;
+    return flags;
+}
+
+// Leading dimension para cols columnas segun las opciones
+static inline int matriz_calcular_ld(int cols, int flags) {
+    int por_linea = MATRIZ_ALINEACION / (int)sizeof(double);
+    int ld = ((cols + por_linea - 1) / por_linea) * por_linea;
+    if ((flags & MATRIZ_RELLENO) && ((size_t)ld * sizeof(double)) % 1024 == 0)
+        ld += por_linea;
+    return ld;
+}
+
+// Reserva memoria alineada; con paginas enormes alinea a 2 MiB y aconseja THP
+static inline void* matriz_reservar(size_t* bytes, int flags) {
+    size_t alineacion = MATRIZ_ALINEACION;
+    if ((flags & MATRIZ_HUGEPAGES) && *bytes >= MATRIZ_PAGINA_ENORME)
+        alineacion = MATRIZ_PAGINA_ENORME;
+    *bytes = ((*bytes + alineacion - 1) / alineacion) * alineacion;
+
+    void* p = NULL;
+    if (posix_memalign(&p, alineacion, *bytes) != 0)
+        return NULL;
+#ifdef MADV_HUGEPAGE
+    if (alineacion == MATRIZ_PAGINA_ENORME)
+        madvise(p, *bytes, MADV_HUGEPAGE);
+#endif
+    return p;
+}
+
+// Crea una matriz filas x cols sin inicializar. Devuelve 0 o -1 si no hay memoria.
+static inline int matriz_crear(matriz* m, int filas, int cols, int flags) {
+    m->filas = filas;
+    m->cols = cols;
+    m->flags = flags;
+    m->ld = matriz_calcular_ld(cols, flags);
+    m->bytes = (size_t)filas * m->ld * sizeof(double);
+    m->datos = (double*) matriz_reservar(&m->bytes, flags);
+    if (m->datos == NULL) {
+        fprintf(stderr, "No se pudo reservar una matriz %dx%d (%zu bytes)\n",
+                filas, cols, m->bytes);
+        return -1;
+    }
+    return 0;
+}
+
+static inline void matriz_liberar(matriz* m) {
+    free(m->datos);
+    m->datos = NULL;
+}
+
+static inline double* matriz_fila(const matriz* m, int i) {
+    return m->datos + (size_t)i * m->ld;
+}
+
+// Vector alineado de n doubles (para x, y); devuelve NULL si no hay memoria
+static inline double* vector_crear(int n, int flags) {
+    size_t bytes = (size_t)n * sizeof(double);
+    return (double*) matriz_reservar(&bytes, flags & MATRIZ_HUGEPAGES);
+}
+
+// Tamaño de problema desde argv[i] (o valor por defecto si no se dio)
+static inline int matriz_argumento(int argc, char* argv[], int i, int defecto) {
+    if (argc <= i) return defecto;
+    int v = (int)strtol(argv[i], NULL, 10);
+    return v > 0 ? v : defecto;
+}
+
+#endif
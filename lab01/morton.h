@@ -0,0 +1,111 @@
+#ifndef MORTON_H
+#define MORTON_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "matriz.h"
+
+// Layout Z-order (Morton) por tiles.
+//
+// La matriz n x n se rellena hasta N = hoja * 2^d y se divide en tiles de
+// hoja x hoja; los tiles se guardan en orden Z (el bit de fila precede al
+// de columna en cada nivel) y cada tile es row-major y contiguo. Asi cada
+// cuadrante, a cualquier nivel de la recursion, ocupa un tramo contiguo de
+// memoria: el cuadrante (r, c) de un bloque de lado s empieza en
+// (2r + c) * (s/2)^2. El relleno queda en cero y no altera el producto.
+
+typedef struct {
+    int n;        // dimension logica
+    int N;        // dimension rellenada (hoja * 2^d)
+    int hoja;     // lado del tile contiguo
+    size_t bytes;
+    double* datos;
+} matriz_morton;
+
+// Intercala los bits de ti (fila) y tj (columna): ...f1 c1 f0 c0
+static inline size_t morton_indice(unsigned ti, unsigned tj) {
+    size_t z = 0;
+    for (int b = 0; b < 16; b++) {
+        z |= (size_t)((tj >> b) & 1u) << (2 * b);
+        z |= (size_t)((ti >> b) & 1u) << (2 * b + 1);
+    }
+    return z;
+}
+
+// Hoja (multiplo de 8, entre 16 y 64) que minimiza el relleno N - n:
+// con una hoja fija de 32, n = 2100 se iria a N = 4096
+static inline int morton_hoja_para(int n) {
+    int mejor_hoja = 64, mejor_N = 0;
+    for (int d = 0; d < 31; d++) {
+        int h = ((((n + (1 << d) - 1) >> d)) + 7) & ~7;
+        if (h > 64) continue;
+        if (h < 16 && d > 0) break;
+        int N = h << d;
+        if (mejor_N == 0 || N < mejor_N) {
+            mejor_N = N;
+            mejor_hoja = h;
+        }
+    }
+    return mejor_hoja;
+}
+
+// hoja <= 0 elige la hoja con morton_hoja_para
+static inline int morton_crear(matriz_morton* m, int n, int hoja, int flags) {
+    if (hoja <= 0) hoja = morton_hoja_para(n);
+    m->n = n;
+    m->hoja = hoja;
+    m->N = hoja;
+    while (m->N < n) m->N *= 2;
+    m->bytes = (size_t)m->N * m->N * sizeof(double);
+    m->datos = (double*) matriz_reservar(&m->bytes, flags);
+    if (m->datos == NULL) {
+        fprintf(stderr, "No se pudo reservar una matriz Morton %dx%d (%zu bytes)\n",
+                m->N, m->N, m->bytes);
+        return -1;
+    }
+    return 0;
+}
+
+static inline void morton_liberar(matriz_morton* m) {
+    free(m->datos);
+    m->datos = NULL;
+}
+
+static inline double* morton_tile(const matriz_morton* m, int ti, int tj) {
+    return m->datos + morton_indice(ti, tj) * m->hoja * m->hoja;
+}
+
+// Copia una matriz row-major (n x n) al layout Morton, con ceros en el relleno
+static inline void morton_desde_filas(matriz_morton* dst, const matriz* src) {
+    int h = dst->hoja, tiles = dst->N / h;
+    for (int ti = 0; ti < tiles; ti++)
+        for (int tj = 0; tj < tiles; tj++) {
+            double* t = morton_tile(dst, ti, tj);
+            for (int r = 0; r < h; r++) {
+                int i = ti * h + r, j0 = tj * h, ancho = 0;
+                if (i < dst->n && j0 < dst->n)
+                    ancho = (dst->n - j0 < h) ? dst->n - j0 : h;
+                if (ancho > 0)
+                    memcpy(t + r * h, matriz_fila(src, i) + j0, ancho * sizeof(double));
+                memset(t + r * h + ancho, 0, (h - ancho) * sizeof(double));
+            }
+        }
+}
+
+// Copia de vuelta al layout row-major (descarta el relleno)
+static inline void morton_a_filas(matriz* dst, const matriz_morton* src) {
+    int h = src->hoja, tiles = (src->n + h - 1) / h;
+    for (int ti = 0; ti < tiles; ti++)
+        for (int tj = 0; tj < tiles; tj++) {
+            const double* t = morton_tile(src, ti, tj);
+            for (int r = 0; r < h && ti * h + r < src->n; r++) {
+                int j0 = tj * h;
+                int ancho = (src->n - j0 < h) ? src->n - j0 : h;
+                memcpy(matriz_fila(dst, ti * h + r) + j0, t + r * h, ancho * sizeof(double));
+            }
+        }
+}
+
+#endif
@@ -0,0 +1,179 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../comun/benchmark.h"
+#include "matriz.h"
+#include "gemm.h"
+#include "autotune.h"
+#include "recursiva.h"
+
+// Compara la multiplicacion cache-oblivious (row-major y Morton) con la
+// version por bloques de enunciado3 y con el motor empaquetado de gemm.h.
+
+matriz A, B, C;
+matriz_morton Am, Bm, Cm;
+
+typedef struct {
+    int n;
+    int block;
+} problema;
+
+void inicializar(int n) {
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            MAT(&A, i, j) = (double)(i + j) / n;
+            MAT(&B, i, j) = (double)(i - j) / n;
+        }
+}
+
+void limpiar_c(void* arg) {
+    int n = ((problema*)arg)->n;
+    for (int i = 0; i < n; i++)
+        memset(matriz_fila(&C, i), 0, n * sizeof(double));
+}
+
+void limpiar_cm(void* arg) {
+    (void)arg;
+    memset(Cm.datos, 0, (size_t)Cm.N * Cm.N * sizeof(double));
+}
+
+// Bloques con axpy vectorial, como multiplicacion_bloques_simd de enunciado3
+void multiplicacion_bloques_simd(void* arg) {
+    problema* p = (problema*)arg;
+    int n = p->n, block = p->block;
+    const simd_kernels* kern = simd_seleccionar();
+    for (int ii = 0; ii < n; ii += block)
+        for (int jj = 0; jj < n; jj += block) {
+            int ancho = (jj + block < n) ? block : n - jj;
+            for (int kk = 0; kk < n; kk += block)
+                for (int i = ii; i < ii + block && i < n; i++)
+                    for (int k = kk; k < kk + block && k < n; k++)
+                        kern->axpy(ancho, MAT(&A, i, k), &MAT(&B, k, jj), &MAT(&C, i, jj));
+        }
+}
+
+void multiplicacion_gemm(void* arg) {
+    int n = ((problema*)arg)->n;
+    gemm(n, n, n, A.datos, A.ld, B.datos, B.ld, C.datos, C.ld);
+}
+
+void multiplicacion_recursiva(void* arg) {
+    int n = ((problema*)arg)->n;
+    matmul_recursiva(n, n, n, A.datos, A.ld, B.datos, B.ld, C.datos, C.ld);
+}
+
+void multiplicacion_morton(void* arg) {
+    (void)arg;
+    matmul_morton(&Am, &Bm, &Cm);
+}
+
+// Ida y vuelta del layout: A y B a Morton, C de vuelta a row-major
+void conversion_morton(void* arg) {
+    (void)arg;
+    morton_desde_filas(&Am, &A);
+    morton_desde_filas(&Bm, &B);
+    morton_a_filas(&C, &Cm);
+}
+
+double gflops(int n, double t) {
+    return 2.0 * n * n * (double)n / (t * 1e9);
+}
+
+// Maxima diferencia entre C y la referencia guardada en ref
+double diferencia(int n, const double* ref) {
+    double d = 0.0;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            double e = MAT(&C, i, j) - ref[(size_t)i * n + j];
+            if (e < 0) e = -e;
+            if (e > d) d = e;
+        }
+    return d;
+}
+
+void guardar_referencia(int n, double* ref) {
+    for (int i = 0; i < n; i++)
+        memcpy(ref + (size_t)i * n, matriz_fila(&C, i), n * sizeof(double));
+}
+
+#define NUM_METODOS 4
+
+// uso: ./recursiva [n ...]   (por defecto 200 500 1000 2000 4000 8000)
+int main(int argc, char* argv[]) {
+    int default_sizes[] = {200, 500, 1000, 2000, 4000, 8000};
+    int num_sizes = (argc > 1) ? argc - 1 : (int)(sizeof(default_sizes) / sizeof(default_sizes[0]));
+    int flags = matriz_flags_entorno();
+    bench_config cfg = bench_config_entorno();
+
+    const char* nombres[NUM_METODOS] = {"bloques_simd", "gemm", "recursiva", "morton"};
+
+    printf("Multiplicacion cache-oblivious vs bloques vs empaquetada (isa=%s, mediana de %d reps)\n",
+           simd_nombre(), cfg.repeticiones);
+    printf("%6s %6s %5s | %-14s %10s %9s %10s\n", "n", "block", "hoja", "metodo",
+           "segundos", "GFLOP/s", "max |dif|");
+
+    for (int si = 0; si < num_sizes; si++) {
+        int n = (argc > 1) ? matriz_argumento(argc, argv, si + 1, 200) : default_sizes[si];
+        if (matriz_crear(&A, n, n, flags) != 0 || matriz_crear(&B, n, n, flags) != 0 ||
+            matriz_crear(&C, n, n, flags) != 0 || morton_crear(&Am, n, 0, flags) != 0 ||
+            morton_crear(&Bm, n, 0, flags) != 0 || morton_crear(&Cm, n, 0, flags) != 0)
+            return 1;
+        double* ref = (double*) malloc((size_t)n * n * sizeof(double));
+        if (ref == NULL) return 1;
+
+        // block de la cache de autoajuste de enunciado3 si existe
+        int p[AUTOTUNE_MAX_PARAMS];
+        problema prob = {n, 32};
+        if (autotune_buscar("bloques_simd", n, p)) prob.block = p[0];
+
+        inicializar(n);
+        void (*metodos[NUM_METODOS])(void*) = {
+            multiplicacion_bloques_simd, multiplicacion_gemm, multiplicacion_recursiva, multiplicacion_morton
+        };
+        void (*preparar[NUM_METODOS])(void*) = {limpiar_c, limpiar_c, limpiar_c, limpiar_cm};
+        bench_stats s[NUM_METODOS + 1];
+        double dif[NUM_METODOS];
+        char nombre[BENCH_MAX_NOMBRE];
+
+        // referencia: una corrida de gemm fuera de la medicion
+        limpiar_c(&prob);
+        multiplicacion_gemm(&prob);
+        guardar_referencia(n, ref);
+
+        morton_desde_filas(&Am, &A);
+        morton_desde_filas(&Bm, &B);
+        for (int m = 0; m < NUM_METODOS; m++) {
+            snprintf(nombre, sizeof(nombre), "recursiva/%s/n=%d", nombres[m], n);
+            s[m] = bench_medir(nombre, &cfg, preparar[m], metodos[m], &prob);
+            if (metodos[m] == multiplicacion_morton) morton_a_filas(&C, &Cm);
+            dif[m] = diferencia(n, ref);
+        }
+
+        snprintf(nombre, sizeof(nombre), "recursiva/conversion_morton/n=%d", n);
+        s[NUM_METODOS] = bench_medir(nombre, &cfg, NULL, conversion_morton, &prob);
+
+        for (int m = 0; m < NUM_METODOS; m++)
+            printf("%6d %6d %5d | %-14s %10f %9.3f %10.2e\n", n, prob.block, Am.hoja, nombres[m],
+                   s[m].mediana, gflops(n, s[m].mediana), dif[m]);
+        double total = s[3].mediana + s[NUM_METODOS].mediana;
+        printf("%6d %6d %5d | %-14s %10f %9.3f %10s\n", n, prob.block, Am.hoja, "morton+conv",
+               total, gflops(n, total), "");
+
+        for (int m = 0; m <= NUM_METODOS; m++)
+            bench_registrar(&cfg, &s[m]);
+
+        free(ref);
+        matriz_liberar(&A);
+        matriz_liberar(&B);
+        matriz_liberar(&C);
+        morton_liberar(&Am);
+        morton_liberar(&Bm);
+        morton_liberar(&Cm);
+    }
+
+    printf("\nmorton: N = hoja * 2^d >= n con relleno en cero; morton+conv suma la\n"
+           "conversion de A y B al layout Z y de C de vuelta a row-major\n");
+    bench_config_cerrar(&cfg);
+    return 0;
+}
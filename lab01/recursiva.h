@@ -0,0 +1,93 @@
+#ifndef RECURSIVA_H
+#define RECURSIVA_H
+
+#include <stdlib.h>
+
+#include "simd.h"
+#include "morton.h"
+
+// Multiplicacion cache-oblivious: C += A * B por divide y venceras.
+//
+// En vez de un block fijo elegido para un nivel de cache, se parte siempre
+// la dimension mas grande por la mitad; en algun nivel de la recursion los
+// subproblemas caben en L1, en otro en L2, en otro en L3, sin conocer sus
+// tamaños. La recursion se corta en una hoja pequeña (RECURSIVA_HOJA por
+// lado) que se resuelve con el axpy vectorial de simd.h.
+//
+// matmul_recursiva trabaja sobre el layout row-major de siempre;
+// matmul_morton sobre matriz_morton, donde cada cuadrante es contiguo y la
+// recursion no necesita leading dimension.
+
+#define RECURSIVA_HOJA 32
+
+// Hoja: orden i-k-j con la fila de B contigua
+static inline void recursiva_hoja(int m, int n, int k, const double* A, int lda,
+                                  const double* B, int ldb, double* C, int ldc,
+                                  const simd_kernels* kern) {
+    for (int i = 0; i < m; i++)
+        for (int p = 0; p < k; p++)
+            kern->axpy(n, A[(size_t)i * lda + p], B + (size_t)p * ldb, C + (size_t)i * ldc);
+}
+
+// Mitad redondeada a multiplo de 8 para que los cortes en columnas dejen
+// las filas alineadas a 64 bytes
+static inline int recursiva_mitad(int x) {
+    int h = ((x / 2) + 7) & ~7;
+    return (h >= x) ? x / 2 : h;
+}
+
+static inline void recursiva_paso(int m, int n, int k, const double* A, int lda,
+                                  const double* B, int ldb, double* C, int ldc,
+                                  const simd_kernels* kern) {
+    if (m <= RECURSIVA_HOJA && n <= RECURSIVA_HOJA && k <= RECURSIVA_HOJA) {
+        recursiva_hoja(m, n, k, A, lda, B, ldb, C, ldc, kern);
+    } else if (m >= n && m >= k) {
+        int h = recursiva_mitad(m);
+        recursiva_paso(h, n, k, A, lda, B, ldb, C, ldc, kern);
+        recursiva_paso(m - h, n, k, A + (size_t)h * lda, lda, B, ldb, C + (size_t)h * ldc, ldc, kern);
+    } else if (n >= k) {
+        int h = recursiva_mitad(n);
+        recursiva_paso(m, h, k, A, lda, B, ldb, C, ldc, kern);
+        recursiva_paso(m, n - h, k, A, lda, B + h, ldb, C + h, ldc, kern);
+    } else {
+        // partir k: ambas mitades acumulan sobre el mismo C, en secuencia
+        int h = recursiva_mitad(k);
+        recursiva_paso(m, n, h, A, lda, B, ldb, C, ldc, kern);
+        recursiva_paso(m, n, k - h, A + h, lda, B + (size_t)h * ldb, ldb, C, ldc, kern);
+    }
+}
+
+static inline void matmul_recursiva(int m, int n, int k, const double* A, int lda,
+                                    const double* B, int ldb, double* C, int ldc) {
+    recursiva_paso(m, n, k, A, lda, B, ldb, C, ldc, simd_seleccionar());
+}
+
+// Bloque de lado s en layout Morton: 8 productos de cuadrantes contiguos
+static inline void morton_paso(int s, int hoja, const double* A, const double* B, double* C,
+                               const simd_kernels* kern) {
+    if (s == hoja) {
+        recursiva_hoja(s, s, s, A, s, B, s, C, s, kern);
+        return;
+    }
+    int h = s / 2;
+    size_t q = (size_t)h * h;
+    const double *A00 = A, *A01 = A + q, *A10 = A + 2 * q, *A11 = A + 3 * q;
+    const double *B00 = B, *B01 = B + q, *B10 = B + 2 * q, *B11 = B + 3 * q;
+    double *C00 = C, *C01 = C + q, *C10 = C + 2 * q, *C11 = C + 3 * q;
+
+    morton_paso(h, hoja, A00, B00, C00, kern);
+    morton_paso(h, hoja, A01, B10, C00, kern);
+    morton_paso(h, hoja, A00, B01, C01, kern);
+    morton_paso(h, hoja, A01, B11, C01, kern);
+    morton_paso(h, hoja, A10, B00, C10, kern);
+    morton_paso(h, hoja, A11, B10, C10, kern);
+    morton_paso(h, hoja, A10, B01, C11, kern);
+    morton_paso(h, hoja, A11, B11, C11, kern);
+}
+
+// C += A * B con las tres matrices en layout Morton del mismo N y hoja
+static inline void matmul_morton(const matriz_morton* A, const matriz_morton* B, matriz_morton* C) {
+    morton_paso(A->N, A->hoja, A->datos, B->datos, C->datos, simd_seleccionar());
+}
+
+#endif
@@ -0,0 +1,369 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+
+// Kernels vectoriales con despacho en tiempo de ejecucion.
+//
+// Cada kernel existe en version escalar, SSE2, AVX2+FMA y AVX-512F; las
+// versiones vectoriales se compilan con __attribute__((target(...))) asi que
+// el mismo binario (compilado sin -march) corre en nodos AVX2 y AVX-512.
+// simd_seleccionar() consulta CPUID una sola vez y devuelve la tabla de
+// funciones mas ancha soportada. La variable de entorno SIMD_ISA
+// (escalar|sse2|avx2|avx512) permite forzar un camino mas estrecho.
+
+// Tamaño del tile de registros que calculan los microkernels
+#define SIMD_MR 4
+#define SIMD_NR 8
+
+typedef enum {
+    ISA_ESCALAR = 0,
+    ISA_SSE2,
+    ISA_AVX2,
+    ISA_AVX512
+} simd_isa;
+
+typedef struct {
+    simd_isa isa;
+    const char* nombre;
+    // producto punto de a y b (n elementos)
+    double (*dot)(int n, const double* a, const double* b);
+    // y += alpha * x (n elementos)
+    void (*axpy)(int n, double alpha, const double* x, double* y);
+    // C[0:mr][0:nr] += Ap * Bp con paneles empaquetados MR x kc y kc x NR
+    void (*microkernel)(int kc, const double* Ap, const double* Bp,
+                        double* C, int ldc, int mr, int nr);
+} simd_kernels;
+
+// Suma un tile completo MR x NR calculado en tmp sobre C (bordes)
+static inline void simd_sumar_tile(const double* tmp, double* C, int ldc, int mr, int nr) {
+    for (int r = 0; r < mr; r++)
+        for (int c = 0; c < nr; c++)
+            C[(size_t)r * ldc + c] += tmp[r * SIMD_NR + c];
+}
+
+//  camino escalar
+
+static inline double dot_escalar(int n, const double* a, const double* b) {
+    double s = 0.0;
+    for (int i = 0; i < n; i++)
+        s += a[i] * b[i];
+    return s;
+}
+
+static inline void axpy_escalar(int n, double alpha, const double* x, double* y) {
+    for (int i = 0; i < n; i++)
+        y[i] += alpha * x[i];
+}
+
+static inline void microkernel_escalar(int kc, const double* Ap, const double* Bp,
+                                double* C, int ldc, int mr, int nr) {
+    double acc[SIMD_MR * SIMD_NR] = {0.0};
+
+    for (int k = 0; k < kc; k++) {
+        for (int r = 0; r < SIMD_MR; r++) {
+            double a = Ap[r];
+            for (int c = 0; c < SIMD_NR; c++)
+                acc[r * SIMD_NR + c] += a * Bp[c];
+        }
+        Ap += SIMD_MR;
+        Bp += SIMD_NR;
+    }
+    simd_sumar_tile(acc, C, ldc, mr, nr);
+}
+
+//  camino SSE2 (2 doubles por registro, sin FMA)
+
+__attribute__((target("sse2")))
+static inline double dot_sse2(int n, const double* a, const double* b) {
+    __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+    double t[2];
+    _mm_storeu_pd(t, _mm_add_pd(s0, s1));
+    double s = t[0] + t[1];
+    for (; i < n; i++)
+        s += a[i] * b[i];
+    return s;
+}
+
+__attribute__((target("sse2")))
+static inline void axpy_sse2(int n, double alpha, const double* x, double* y) {
+    __m128d va = _mm_set1_pd(alpha);
+    int i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i),
+                                        _mm_mul_pd(va, _mm_loadu_pd(x + i))));
+    for (; i < n; i++)
+        y[i] += alpha * x[i];
+}
+
+__attribute__((target("sse2")))
+static inline void microkernel_sse2(int kc, const double* Ap, const double* Bp,
+                             double* C, int ldc, int mr, int nr) {
+    __m128d acc[SIMD_MR][4];
+    for (int r = 0; r < SIMD_MR; r++)
+        for (int c = 0; c < 4; c++)
+            acc[r][c] = _mm_setzero_pd();
+
+    for (int k = 0; k < kc; k++) {
+        __m128d b0 = _mm_load_pd(Bp);
+        __m128d b1 = _mm_load_pd(Bp + 2);
+        __m128d b2 = _mm_load_pd(Bp + 4);
+        __m128d b3 = _mm_load_pd(Bp + 6);
+        for (int r = 0; r < SIMD_MR; r++) {
+            __m128d a = _mm_set1_pd(Ap[r]);
+            acc[r][0] = _mm_add_pd(acc[r][0], _mm_mul_pd(a, b0));
+            acc[r][1] = _mm_add_pd(acc[r][1], _mm_mul_pd(a, b1));
+            acc[r][2] = _mm_add_pd(acc[r][2], _mm_mul_pd(a, b2));
+            acc[r][3] = _mm_add_pd(acc[r][3], _mm_mul_pd(a, b3));
+        }
+        Ap += SIMD_MR;
+        Bp += SIMD_NR;
+    }
+
+    if (mr == SIMD_MR && nr == SIMD_NR) {
+        for (int r = 0; r < SIMD_MR; r++) {
+            double* fila = C + (size_t)r * ldc;
+            for (int c = 0; c < 4; c++)
+                _mm_storeu_pd(fila + 2 * c, _mm_add_pd(_mm_loadu_pd(fila + 2 * c), acc[r][c]));
+        }
+    } else {
+        double tmp[SIMD_MR * SIMD_NR];
+        for (int r = 0; r < SIMD_MR; r++)
+            for (int c = 0; c < 4; c++)
+                _mm_storeu_pd(tmp + r * SIMD_NR + 2 * c, acc[r][c]);
+        simd_sumar_tile(tmp, C, ldc, mr, nr);
+    }
+}
+
+//  camino AVX2 + FMA (4 doubles por registro)
+
+__attribute__((target("avx2,fma")))
+static inline double dot_avx2(int n, const double* a, const double* b) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4), s1);
+        s2 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8), s2);
+        s3 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12), s3);
+    }
+    for (; i + 4 <= n; i += 4)
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), s0);
+    __m256d s = _mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3));
+    __m128d h = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+    double r = _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+    for (; i < n; i++)
+        r += a[i] * b[i];
+    return r;
+}
+
+__attribute__((target("avx2,fma")))
+static inline void axpy_avx2(int n, double alpha, const double* x, double* y) {
+    __m256d va = _mm256_set1_pd(alpha);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        _mm256_storeu_pd(y + i + 4, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    for (; i < n; i++)
+        y[i] += alpha * x[i];
+}
+
+__attribute__((target("avx2,fma")))
+static inline void microkernel_avx2(int kc, const double* Ap, const double* Bp,
+                             double* C, int ldc, int mr, int nr) {
+    // 4 filas x 2 registros = 8 acumuladores independientes
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+
+    for (int k = 0; k < kc; k++) {
+        __m256d b0 = _mm256_load_pd(Bp);
+        __m256d b1 = _mm256_load_pd(Bp + 4);
+        __m256d a;
+        a = _mm256_broadcast_sd(Ap + 0);
+        c00 = _mm256_fmadd_pd(a, b0, c00); c01 = _mm256_fmadd_pd(a, b1, c01);
+        a = _mm256_broadcast_sd(Ap + 1);
+        c10 = _mm256_fmadd_pd(a, b0, c10); c11 = _mm256_fmadd_pd(a, b1, c11);
+        a = _mm256_broadcast_sd(Ap + 2);
+        c20 = _mm256_fmadd_pd(a, b0, c20); c21 = _mm256_fmadd_pd(a, b1, c21);
+        a = _mm256_broadcast_sd(Ap + 3);
+        c30 = _mm256_fmadd_pd(a, b0, c30); c31 = _mm256_fmadd_pd(a, b1, c31);
+        Ap += SIMD_MR;
+        Bp += SIMD_NR;
+    }
+
+    double tmp[SIMD_MR * SIMD_NR];
+    double* dst = tmp;
+    int ld = SIMD_NR;
+    if (mr == SIMD_MR && nr == SIMD_NR) {
+        // tile completo: sumar directamente sobre C
+        dst = C;
+        ld = ldc;
+        c00 = _mm256_add_pd(c00, _mm256_loadu_pd(dst + 0 * (size_t)ld));
+        c01 = _mm256_add_pd(c01, _mm256_loadu_pd(dst + 0 * (size_t)ld + 4));
+        c10 = _mm256_add_pd(c10, _mm256_loadu_pd(dst + 1 * (size_t)ld));
+        c11 = _mm256_add_pd(c11, _mm256_loadu_pd(dst + 1 * (size_t)ld + 4));
+        c20 = _mm256_add_pd(c20, _mm256_loadu_pd(dst + 2 * (size_t)ld));
+        c21 = _mm256_add_pd(c21, _mm256_loadu_pd(dst + 2 * (size_t)ld + 4));
+        c30 = _mm256_add_pd(c30, _mm256_loadu_pd(dst + 3 * (size_t)ld));
+        c31 = _mm256_add_pd(c31, _mm256_loadu_pd(dst + 3 * (size_t)ld + 4));
+    }
+    _mm256_storeu_pd(dst + 0 * (size_t)ld, c00); _mm256_storeu_pd(dst + 0 * (size_t)ld + 4, c01);
+    _mm256_storeu_pd(dst + 1 * (size_t)ld, c10); _mm256_storeu_pd(dst + 1 * (size_t)ld + 4, c11);
+    _mm256_storeu_pd(dst + 2 * (size_t)ld, c20); _mm256_storeu_pd(dst + 2 * (size_t)ld + 4, c21);
+    _mm256_storeu_pd(dst + 3 * (size_t)ld, c30); _mm256_storeu_pd(dst + 3 * (size_t)ld + 4, c31);
+    if (dst == tmp)
+        simd_sumar_tile(tmp, C, ldc, mr, nr);
+}
+
+//  camino AVX-512F (8 doubles por registro, colas con mascara)
+
+__attribute__((target("avx512f")))
+static inline double dot_avx512(int n, const double* a, const double* b) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+    __m512d s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+        s1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8), s1);
+        s2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16), s2);
+        s3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24), s3);
+    }
+    for (; i + 8 <= n; i += 8)
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i), s0);
+    if (i < n) {
+        __mmask8 m = (__mmask8)((1u << (n - i)) - 1);
+        s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i), s1);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+}
+
+__attribute__((target("avx512f")))
+static inline void axpy_avx512(int n, double alpha, const double* x, double* y) {
+    __m512d va = _mm512_set1_pd(alpha);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+        _mm512_storeu_pd(y + i + 8, _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8)));
+    }
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(va, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    if (i < n) {
+        __mmask8 m = (__mmask8)((1u << (n - i)) - 1);
+        __m512d vy = _mm512_fmadd_pd(va, _mm512_maskz_loadu_pd(m, x + i), _mm512_maskz_loadu_pd(m, y + i));
+        _mm512_mask_storeu_pd(y + i, m, vy);
+    }
+}
+
+__attribute__((target("avx512f")))
+static inline void microkernel_avx512(int kc, const double* Ap, const double* Bp,
+                               double* C, int ldc, int mr, int nr) {
+    // una fila del tile por registro; se desenrolla k x2 con dos juegos de
+    // acumuladores para tener 8 cadenas FMA independientes
+    __m512d c0 = _mm512_setzero_pd(), c1 = _mm512_setzero_pd();
+    __m512d c2 = _mm512_setzero_pd(), c3 = _mm512_setzero_pd();
+    __m512d d0 = _mm512_setzero_pd(), d1 = _mm512_setzero_pd();
+    __m512d d2 = _mm512_setzero_pd(), d3 = _mm512_setzero_pd();
+
+    int k = 0;
+    for (; k + 2 <= kc; k += 2) {
+        __m512d b = _mm512_load_pd(Bp);
+        __m512d e = _mm512_load_pd(Bp + SIMD_NR);
+        c0 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[0]), b, c0);
+        c1 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[1]), b, c1);
+        c2 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[2]), b, c2);
+        c3 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[3]), b, c3);
+        d0 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[4]), e, d0);
+        d1 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[5]), e, d1);
+        d2 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[6]), e, d2);
+        d3 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[7]), e, d3);
+        Ap += 2 * SIMD_MR;
+        Bp += 2 * SIMD_NR;
+    }
+    if (k < kc) {
+        __m512d b = _mm512_load_pd(Bp);
+        c0 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[0]), b, c0);
+        c1 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[1]), b, c1);
+        c2 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[2]), b, c2);
+        c3 = _mm512_fmadd_pd(_mm512_set1_pd(Ap[3]), b, c3);
+    }
+    c0 = _mm512_add_pd(c0, d0);
+    c1 = _mm512_add_pd(c1, d1);
+    c2 = _mm512_add_pd(c2, d2);
+    c3 = _mm512_add_pd(c3, d3);
+
+    // las columnas validas se cubren con una mascara; las filas con mr
+    __mmask8 m = (__mmask8)((1u << nr) - 1);
+    __m512d filas[SIMD_MR] = {c0, c1, c2, c3};
+    for (int r = 0; r < mr; r++) {
+        double* fila = C + (size_t)r * ldc;
+        _mm512_mask_storeu_pd(fila, m, _mm512_add_pd(filas[r], _mm512_maskz_loadu_pd(m, fila)));
+    }
+}
+
+//  seleccion por CPUID
+
+static const simd_kernels SIMD_TABLA[] = {
+    {ISA_ESCALAR, "escalar", dot_escalar, axpy_escalar, microkernel_escalar},
+    {ISA_SSE2, "sse2", dot_sse2, axpy_sse2, microkernel_sse2},
+    {ISA_AVX2, "avx2+fma", dot_avx2, axpy_avx2, microkernel_avx2},
+    {ISA_AVX512, "avx512f", dot_avx512, axpy_avx512, microkernel_avx512},
+};
+
+// Valores de SIMD_ISA, en el orden de simd_isa (tambien se acepta el nombre
+// completo de SIMD_TABLA)
+static const char* const SIMD_CLAVES[] = {"escalar", "sse2", "avx2", "avx512"};
+
+static inline simd_isa simd_detectar(void) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return ISA_AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return ISA_AVX2;
+    if (__builtin_cpu_supports("sse2")) return ISA_SSE2;
+    return ISA_ESCALAR;
+}
+
+static inline const simd_kernels* simd_seleccionar(void) {
+    static const simd_kernels* elegido = NULL;
+    if (elegido != NULL) return elegido;
+
+    simd_isa isa = simd_detectar();
+
+    // SIMD_ISA solo puede estrechar el camino, nunca habilitar uno no soportado;
+    // vacia cuenta como no definida
+    const char* forzado = getenv("SIMD_ISA");
+    if (forzado != NULL && forzado[0] != '\0') {
+        int pedido = -1;
+        for (int i = 0; i <= (int)ISA_AVX512; i++) {
+            if (strcmp(forzado, SIMD_CLAVES[i]) == 0 || strcmp(forzado, SIMD_TABLA[i].nombre) == 0)
+                pedido = i;
+        }
+        if (pedido < 0)
+            fprintf(stderr, "simd: SIMD_ISA=%s desconocido (escalar|sse2|avx2|avx512), se usa %s\n",
+                    forzado, SIMD_TABLA[isa].nombre);
+        else if (pedido > (int)isa)
+            fprintf(stderr, "simd: esta CPU no soporta SIMD_ISA=%s, se usa %s\n",
+                    forzado, SIMD_TABLA[isa].nombre);
+        else
+            isa = (simd_isa)pedido;
+    }
+
+    elegido = &SIMD_TABLA[isa];
+    return elegido;
+}
+
+static inline const char* simd_nombre(void) {
+    return simd_seleccionar()->nombre;
+}
+
+#endif
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../comun/benchmark.h"
+#include "matriz.h"
+#include "strassen.h"
+
+// Strassen-Winograd contra el producto clasico empaquetado (gemm.h):
+// tiempo por corte, error respecto del clasico y tamaño a partir del cual
+// conviene activarlo.
+
+matriz A, B, C, R;
+strassen_arena arena;
+// buffers de empaquetado de la referencia, reservados una vez como los de la
+// arena para que la comparacion no incluya las reservas por llamada de gemm()
+gemm_bloques bl;
+double *Ap, *Bp;
+
+typedef struct {
+    int n;
+} problema;
+
+void inicializar(int n) {
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            // valores en [-1, 1] sin estructura para que el error sea representativo
+            MAT(&A, i, j) = sin(0.7 * i + 1.3 * j);
+            MAT(&B, i, j) = cos(1.1 * i - 0.4 * j);
+        }
+}
+
+void limpiar_c(void* arg) {
+    int n = ((problema*)arg)->n;
+    for (int i = 0; i < n; i++)
+        memset(matriz_fila(&C, i), 0, n * sizeof(double));
+}
+
+void multiplicacion_gemm(void* arg) {
+    int n = ((problema*)arg)->n;
+    gemm_con_buffers(n, n, n, A.datos, A.ld, B.datos, B.ld, C.datos, C.ld, bl, Ap, Bp);
+}
+
+void multiplicacion_strassen(void* arg) {
+    int n = ((problema*)arg)->n;
+    strassen_con_arena(n, n, n, A.datos, A.ld, B.datos, B.ld, C.datos, C.ld, &arena);
+}
+
+// Error relativo en norma de Frobenius de C respecto de R
+double error_relativo(int n) {
+    double num = 0.0, den = 0.0;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            double d = MAT(&C, i, j) - MAT(&R, i, j);
+            num += d * d;
+            den += MAT(&R, i, j) * MAT(&R, i, j);
+        }
+    return den > 0.0 ? sqrt(num / den) : sqrt(num);
+}
+
+#define MAX_CORTES 8
+
+// uso: ./strassen [n ...]   (por defecto 500 1000 1500 2000 3000)
+// STRASSEN_CORTES="64 128 256 512" cambia los cortes probados
+int main(int argc, char* argv[]) {
+    int default_sizes[] = {500, 1000, 1500, 2000, 3000};
+    int num_sizes = (argc > 1) ? argc - 1 : (int)(sizeof(default_sizes) / sizeof(default_sizes[0]));
+    int cortes[MAX_CORTES] = {64, 128, 256, 512};
+    int num_cortes = 4;
+    int flags = matriz_flags_entorno();
+    bench_config cfg = bench_config_entorno();
+
+    const char* lista = getenv("STRASSEN_CORTES");
+    if (lista != NULL && lista[0] != '\0') {
+        char* fin;
+        num_cortes = 0;
+        for (long v = strtol(lista, &fin, 10); fin != lista && num_cortes < MAX_CORTES;
+             lista = fin, v = strtol(lista, &fin, 10))
+            if (v > 0) cortes[num_cortes++] = (int)v;
+    }
+
+    bl = gemm_normalizar(GEMM_BLOQUES_DEFECTO);
+    Ap = (double*) aligned_alloc(64, gemm_bytes_a(bl));
+    Bp = (double*) aligned_alloc(64, gemm_bytes_b(bl));
+    if (Ap == NULL || Bp == NULL) return 1;
+
+    int cruce = 0;   // menor n en el que el mejor corte le gana a gemm
+
+    printf("Strassen-Winograd vs gemm (isa=%s, mediana de %d reps)\n", simd_nombre(), cfg.repeticiones);
+    printf("%6s | %-10s %10s %9s %8s %12s %10s\n", "n", "metodo", "segundos", "GFLOP/s*",
+           "speedup", "err. rel.", "arena MiB");
+
+    for (int si = 0; si < num_sizes; si++) {
+        int n = (argc > 1) ? matriz_argumento(argc, argv, si + 1, 500) : default_sizes[si];
+        if (matriz_crear(&A, n, n, flags) != 0 || matriz_crear(&B, n, n, flags) != 0 ||
+            matriz_crear(&C, n, n, flags) != 0 || matriz_crear(&R, n, n, flags) != 0)
+            return 1;
+        inicializar(n);
+        problema prob = {n};
+        char nombre[BENCH_MAX_NOMBRE];
+        double flops = 2.0 * n * n * (double)n;
+
+        snprintf(nombre, sizeof(nombre), "strassen/gemm/n=%d", n);
+        bench_stats base = bench_medir(nombre, &cfg, limpiar_c, multiplicacion_gemm, &prob);
+        for (int i = 0; i < n; i++)
+            memcpy(matriz_fila(&R, i), matriz_fila(&C, i), n * sizeof(double));
+        printf("%6d | %-10s %10f %9.3f %8s %12s %10s\n", n, "gemm", base.mediana,
+               flops / (base.mediana * 1e9), "1.00", "-", "-");
+        bench_registrar(&cfg, &base);
+
+        double mejor = base.mediana;
+        for (int c = 0; c < num_cortes; c++) {
+            if (strassen_arena_crear(&arena, n, n, n, cortes[c]) != 0) return 1;
+            snprintf(nombre, sizeof(nombre), "strassen/corte=%d/n=%d", cortes[c], n);
+            bench_stats s = bench_medir(nombre, &cfg, NULL, multiplicacion_strassen, &prob);
+            char metodo[32];
+            snprintf(metodo, sizeof(metodo), "corte %d", cortes[c]);
+            printf("%6d | %-10s %10f %9.3f %8.2f %12.3e %10.1f\n", n, metodo, s.mediana,
+                   flops / (s.mediana * 1e9), base.mediana / s.mediana, error_relativo(n),
+                   arena.doubles * sizeof(double) / (1024.0 * 1024.0));
+            bench_registrar(&cfg, &s);
+            if (s.mediana < mejor) mejor = s.mediana;
+            strassen_arena_liberar(&arena);
+        }
+        if (mejor < base.mediana && cruce == 0) cruce = n;
+        if (mejor >= base.mediana) cruce = 0;
+
+        matriz_liberar(&A);
+        matriz_liberar(&B);
+        matriz_liberar(&C);
+        matriz_liberar(&R);
+    }
+
+    printf("\n* GFLOP/s efectivos: 2n^3 / tiempo, aunque Strassen hace menos operaciones\n");
+    if (cruce > 0)
+        printf("Cruce: Strassen gana desde n = %d en los tamaños probados\n", cruce);
+    else
+        printf("Cruce: Strassen no le gana a gemm en el mayor tamaño probado\n");
+    free(Ap);
+    free(Bp);
+    bench_config_cerrar(&cfg);
+    return 0;
+}
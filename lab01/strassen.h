@@ -0,0 +1,189 @@
+#ifndef STRASSEN_H
+#define STRASSEN_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "gemm.h"
+
+// Multiplicacion rapida Strassen-Winograd: C = A * B (sobrescribe C).
+//
+// Cada nivel reemplaza 8 productos de cuadrantes por 7 (y 15 sumas), hasta
+// que alguna dimension baja del corte y el subproblema pasa al motor
+// empaquetado de gemm.h. El orden de operaciones usa solo tres temporales
+// por nivel (X: m/2 x k/2, Y: k/2 x n/2, Z: m/2 x n/2) y los cuatro
+// cuadrantes de C como almacenamiento intermedio.
+//
+// Toda la memoria de trabajo sale de una arena reservada una sola vez: los
+// temporales de cada nivel se toman como una pila (los hijos usan lo que
+// sigue a los del padre) y los buffers de empaquetado de gemm se comparten
+// entre todas las hojas.
+//
+// Dimensiones impares: peeling dinamico. El nivel trabaja sobre la parte par
+// (m & ~1, k & ~1, n & ~1) y corrige despues con operaciones O(n^2): un
+// update de rango 1 si k es impar, la ultima columna si n es impar y la
+// ultima fila si m es impar.
+//
+// El error es algo mayor que el del producto clasico (las restas de
+// cuadrantes pierden digitos); strassen.c lo mide contra gemm.
+
+#define STRASSEN_CORTE 256
+
+typedef struct {
+    double* base;
+    size_t doubles;     // tamaño de la pila de temporales
+    int corte;
+    gemm_bloques bl;
+    double* Ap;         // buffers de empaquetado de gemm
+    double* Bp;
+} strassen_arena;
+
+static inline size_t strassen_redondear(size_t doubles) {
+    return (doubles + 7) & ~(size_t)7;
+}
+
+static inline int strassen_es_hoja(int m, int n, int k, int corte) {
+    return m <= corte || n <= corte || k <= corte;
+}
+
+// Doubles de temporales que necesita un producto m x k x n con este corte
+static inline size_t strassen_espacio(int m, int n, int k, int corte) {
+    if (strassen_es_hoja(m, n, k, corte)) return 0;
+    int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    size_t nivel = strassen_redondear((size_t)m2 * k2) + strassen_redondear((size_t)k2 * n2) +
+                   strassen_redondear((size_t)m2 * n2);
+    return nivel + strassen_espacio(m2, n2, k2, corte);
+}
+
+// Reserva la arena para productos de hasta m x k x n. Devuelve 0 o -1.
+static inline int strassen_arena_crear(strassen_arena* a, int m, int n, int k, int corte) {
+    memset(a, 0, sizeof(*a));
+    a->corte = corte > 0 ? corte : STRASSEN_CORTE;
+    a->bl = gemm_normalizar(GEMM_BLOQUES_DEFECTO);
+    a->doubles = strassen_espacio(m, n, k, a->corte);
+
+    size_t bytes = a->doubles * sizeof(double) + gemm_bytes_a(a->bl) + gemm_bytes_b(a->bl);
+    a->base = (double*) aligned_alloc(64, ((bytes + 63) / 64) * 64);
+    if (a->base == NULL) return -1;
+    a->Ap = a->base + a->doubles;
+    a->Bp = (double*)((char*)a->Ap + gemm_bytes_a(a->bl));
+    return 0;
+}
+
+static inline void strassen_arena_liberar(strassen_arena* a) {
+    free(a->base);
+    a->base = NULL;
+}
+
+// C = A + signo * B (m x n); C puede coincidir con A o con B
+static inline void strassen_sumar(int m, int n, const double* A, int lda,
+                                  const double* B, int ldb, double signo,
+                                  double* C, int ldc) {
+    for (int i = 0; i < m; i++) {
+        const double* a = A + (size_t)i * lda;
+        const double* b = B + (size_t)i * ldb;
+        double* c = C + (size_t)i * ldc;
+        for (int j = 0; j < n; j++)
+            c[j] = a[j] + signo * b[j];
+    }
+}
+
+static inline void strassen_paso(int m, int n, int k, const double* A, int lda,
+                                 const double* B, int ldb, double* C, int ldc,
+                                 double* ws, strassen_arena* a);
+
+// Un nivel de Winograd sobre dimensiones pares
+static inline void strassen_winograd(int m, int n, int k, const double* A, int lda,
+                                     const double* B, int ldb, double* C, int ldc,
+                                     double* ws, strassen_arena* a) {
+    int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+    const double *A11 = A, *A12 = A + k2, *A21 = A + (size_t)m2 * lda, *A22 = A21 + k2;
+    const double *B11 = B, *B12 = B + n2, *B21 = B + (size_t)k2 * ldb, *B22 = B21 + n2;
+    double *C11 = C, *C12 = C + n2, *C21 = C + (size_t)m2 * ldc, *C22 = C21 + n2;
+
+    double* X = ws;
+    double* Y = X + strassen_redondear((size_t)m2 * k2);
+    double* Z = Y + strassen_redondear((size_t)k2 * n2);
+    double* hijos = Z + strassen_redondear((size_t)m2 * n2);
+
+    strassen_sumar(m2, k2, A11, lda, A21, lda, -1.0, X, k2);          // S3
+    strassen_sumar(k2, n2, B22, ldb, B12, ldb, -1.0, Y, n2);          // T3
+    strassen_paso(m2, n2, k2, X, k2, Y, n2, C21, ldc, hijos, a);      // P7
+    strassen_sumar(m2, k2, A21, lda, A22, lda, 1.0, X, k2);           // S1
+    strassen_sumar(k2, n2, B12, ldb, B11, ldb, -1.0, Y, n2);          // T1
+    strassen_paso(m2, n2, k2, X, k2, Y, n2, C22, ldc, hijos, a);      // P5
+    strassen_sumar(m2, k2, X, k2, A11, lda, -1.0, X, k2);             // S2
+    strassen_sumar(k2, n2, B22, ldb, Y, n2, -1.0, Y, n2);             // T2
+    strassen_paso(m2, n2, k2, X, k2, Y, n2, C12, ldc, hijos, a);      // P6
+    strassen_sumar(m2, k2, A12, lda, X, k2, -1.0, X, k2);             // S4
+    strassen_paso(m2, n2, k2, X, k2, B22, ldb, C11, ldc, hijos, a);   // P3
+    strassen_paso(m2, n2, k2, A11, lda, B11, ldb, Z, n2, hijos, a);   // P1
+    strassen_sumar(m2, n2, C12, ldc, Z, n2, 1.0, C12, ldc);           // U2 = P1 + P6
+    strassen_sumar(m2, n2, C21, ldc, C12, ldc, 1.0, C21, ldc);        // U3 = U2 + P7
+    strassen_sumar(m2, n2, C12, ldc, C22, ldc, 1.0, C12, ldc);        // U4 = U2 + P5
+    strassen_sumar(m2, n2, C22, ldc, C21, ldc, 1.0, C22, ldc);        // U7 = U3 + P5
+    strassen_sumar(m2, n2, C12, ldc, C11, ldc, 1.0, C12, ldc);        // U5 = U4 + P3
+    strassen_sumar(k2, n2, Y, n2, B21, ldb, -1.0, Y, n2);             // T4
+    strassen_paso(m2, n2, k2, A22, lda, Y, n2, C11, ldc, hijos, a);   // P4
+    strassen_sumar(m2, n2, C21, ldc, C11, ldc, -1.0, C21, ldc);       // U6 = U3 - P4
+    strassen_paso(m2, n2, k2, A12, lda, B21, ldb, C11, ldc, hijos, a); // P2
+    strassen_sumar(m2, n2, C11, ldc, Z, n2, 1.0, C11, ldc);           // U1 = P1 + P2
+}
+
+static inline void strassen_paso(int m, int n, int k, const double* A, int lda,
+                                 const double* B, int ldb, double* C, int ldc,
+                                 double* ws, strassen_arena* a) {
+    if (strassen_es_hoja(m, n, k, a->corte)) {
+        for (int i = 0; i < m; i++)
+            memset(C + (size_t)i * ldc, 0, n * sizeof(double));
+        gemm_con_buffers(m, n, k, A, lda, B, ldb, C, ldc, a->bl, a->Ap, a->Bp);
+        return;
+    }
+
+    int mp = m & ~1, np = n & ~1, kp = k & ~1;
+    strassen_winograd(mp, np, kp, A, lda, B, ldb, C, ldc, ws, a);
+
+    const simd_kernels* kern = simd_seleccionar();
+    // k impar: C[0:mp, 0:np] += A[0:mp, k-1] * B[k-1, 0:np]
+    if (kp < k) {
+        for (int i = 0; i < mp; i++)
+            kern->axpy(np, A[(size_t)i * lda + kp], B + (size_t)kp * ldb, C + (size_t)i * ldc);
+    }
+    // n impar: ultima columna de las primeras mp filas
+    if (np < n) {
+        for (int i = 0; i < mp; i++) {
+            double suma = 0.0;
+            for (int p = 0; p < k; p++)
+                suma += A[(size_t)i * lda + p] * B[(size_t)p * ldb + np];
+            C[(size_t)i * ldc + np] = suma;
+        }
+    }
+    // m impar: ultima fila completa
+    if (mp < m) {
+        double* c = C + (size_t)mp * ldc;
+        memset(c, 0, n * sizeof(double));
+        for (int p = 0; p < k; p++)
+            kern->axpy(n, A[(size_t)mp * lda + p], B + (size_t)p * ldb, c);
+    }
+}
+
+// C = A * B usando una arena ya creada para dimensiones >= m, n, k
+static inline void strassen_con_arena(int m, int n, int k, const double* A, int lda,
+                                      const double* B, int ldb, double* C, int ldc,
+                                      strassen_arena* a) {
+    if (m <= 0 || n <= 0) return;
+    strassen_paso(m, n, k, A, lda, B, ldb, C, ldc, a->base, a);
+}
+
+// C = A * B (m x n). corte <= 0 usa STRASSEN_CORTE. Devuelve 0 o -1 si no
+// se pudo reservar la arena.
+static inline int strassen(int m, int n, int k, const double* A, int lda,
+                           const double* B, int ldb, double* C, int ldc, int corte) {
+    strassen_arena a;
+    if (strassen_arena_crear(&a, m, n, k, corte) != 0) return -1;
+    strassen_con_arena(m, n, k, A, lda, B, ldb, C, ldc, &a);
+    strassen_arena_liberar(&a);
+    return 0;
+}
+
+#endif
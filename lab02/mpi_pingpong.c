@@ -3,8 +3,37 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include "../comun/benchmark.h"
+
 #define PINGPONG_LIMIT 100000  // número de iteraciones para medir tiempos
 
+typedef struct {
+    int rank;
+    int partner;
+    int msg;
+} pingpong;
+
+// Una muestra de PINGPONG_LIMIT idas y vueltas medida con MPI_Wtime();
+// la barrera alinea el inicio en ambos procesos
+double muestra_pingpong(void* arg) {
+    pingpong* p = (pingpong*)arg;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start_wtime = MPI_Wtime();
+
+    for (int i = 0; i < PINGPONG_LIMIT; i++) {
+        if (p->rank == 0) {
+            MPI_Send(&p->msg, 1, MPI_INT, p->partner, 1, MPI_COMM_WORLD);
+            MPI_Recv(&p->msg, 1, MPI_INT, p->partner, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        } else if (p->rank == 1) {
+            MPI_Recv(&p->msg, 1, MPI_INT, p->partner, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            MPI_Send(&p->msg, 1, MPI_INT, p->partner, 1, MPI_COMM_WORLD);
+        }
+    }
+
+    return MPI_Wtime() - start_wtime;
+}
+
 int main(int argc, char** argv) {
     MPI_Init(&argc, &argv);
 
@@ -38,30 +67,23 @@ int main(int argc, char** argv) {
     end_clock = clock();
     double elapsed_clock = ((double)(end_clock - start_clock)) / CLOCKS_PER_SEC;
 
-    // ==== Medición con MPI_Wtime() ====
-    MPI_Barrier(MPI_COMM_WORLD);
-    double start_wtime = MPI_Wtime();
-
-    for (int i = 0; i < PINGPONG_LIMIT; i++) {
-        if (rank == 0) {
-            MPI_Send(&msg, 1, MPI_INT, partner, 1, MPI_COMM_WORLD);
-            MPI_Recv(&msg, 1, MPI_INT, partner, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-        } else if (rank == 1) {
-            MPI_Recv(&msg, 1, MPI_INT, partner, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-            MPI_Send(&msg, 1, MPI_INT, partner, 1, MPI_COMM_WORLD);
-        }
-    }
-
-    double end_wtime = MPI_Wtime();
-    double elapsed_wtime = end_wtime - start_wtime;
+    // ==== Medición con MPI_Wtime(), repetida con el arnés común ====
+    // todos los procesos repiten la muestra (el ping-pong necesita a ambos);
+    // solo el proceso 0 reporta
+    bench_config cfg = bench_config_entorno();
+    pingpong p = {rank, partner, msg};
+    bench_stats s = bench_repetir("pingpong/mpi_wtime", &cfg, muestra_pingpong, &p);
 
     if (rank == 0) {
         printf("Ping-Pong con %d iteraciones\n", PINGPONG_LIMIT);
         printf("Tiempo medido con clock():   %f segundos\n", elapsed_clock);
-        printf("Tiempo medido con MPI_Wtime(): %f segundos\n", elapsed_wtime);
+        printf("Tiempo medido con MPI_Wtime(): %f segundos (mediana de %d)\n",
+               s.mediana, s.muestras);
         printf("Tiempo promedio por ping-pong (MPI_Wtime): %e segundos\n",
-               elapsed_wtime / PINGPONG_LIMIT);
+               s.mediana / PINGPONG_LIMIT);
+        bench_reportar(&cfg, &s);
     }
+    bench_config_cerrar(&cfg);
 
     MPI_Finalize();
     return 0;
@@ -2,10 +2,69 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "../comun/benchmark.h"
+
+typedef struct {
+    int rank, size, n;
+    int block_size, cyclic_size, recv_count;
+    int *block_part, *cyclic_part, *block_part_back;
+} redistribucion;
+
+// Enviar desde block a cada proceso en orden cíclico y recibir la parte cíclica
+void block_a_cyclic(redistribucion* r) {
+    for (int i = 0; i < r->block_size; i++) {
+        int global_index = r->rank * r->block_size + i;
+        int target_proc = global_index % r->size;
+        int pos_in_target = global_index / r->size;
+        MPI_Send(&r->block_part[i], 1, MPI_INT, target_proc, pos_in_target, MPI_COMM_WORLD);
+    }
+
+    r->recv_count = 0;
+    for (int i = 0; i < r->cyclic_size; i++) {
+        MPI_Status status;
+        if (r->rank + i * r->size < r->n) {
+            MPI_Recv(&r->cyclic_part[i], 1, MPI_INT, MPI_ANY_SOURCE, i, MPI_COMM_WORLD, &status);
+            r->recv_count++;
+        }
+    }
+}
+
+void cyclic_a_block(redistribucion* r) {
+    for (int i = 0; i < r->recv_count; i++) {
+        int global_index = i * r->size + r->rank;
+        int target_proc = global_index / r->block_size;
+        int pos_in_target = global_index % r->block_size;
+        MPI_Send(&r->cyclic_part[i], 1, MPI_INT, target_proc, pos_in_target, MPI_COMM_WORLD);
+    }
+
+    for (int i = 0; i < r->block_size; i++) {
+        MPI_Status status;
+        MPI_Recv(&r->block_part_back[i], 1, MPI_INT, MPI_ANY_SOURCE, i, MPI_COMM_WORLD, &status);
+    }
+}
+
+// Muestras para el arnés: la barrera alinea el inicio y se reporta el
+// tiempo del proceso más lento, que es el que define la redistribución
+double muestra_fase(void (*fase)(redistribucion*), redistribucion* r) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    fase(r);
+    double local = MPI_Wtime() - start, global;
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return global;
+}
+
+double muestra_block_a_cyclic(void* arg) {
+    return muestra_fase(block_a_cyclic, (redistribucion*)arg);
+}
+
+double muestra_cyclic_a_block(void* arg) {
+    return muestra_fase(cyclic_a_block, (redistribucion*)arg);
+}
+
 int main(int argc, char* argv[]) {
     int rank, size, n = 16;  // Tamaño del vector global (ejemplo n=16)
     int *global_vector = NULL;
-    double start, end;
 
     MPI_Init(&argc, &argv);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -38,54 +97,28 @@ int main(int argc, char* argv[]) {
     int cyclic_size = (n + size - 1) / size; // en caso no divisible exacto
     int *cyclic_part = (int*) malloc(cyclic_size * sizeof(int));
 
-    start = MPI_Wtime();
-
-    // Enviar desde block a cada proceso en orden cíclico
-    for (int i = 0; i < block_size; i++) {
-        int global_index = rank * block_size + i;
-        int target_proc = global_index % size;
-        int pos_in_target = global_index / size;
-        MPI_Send(&block_part[i], 1, MPI_INT, target_proc, pos_in_target, MPI_COMM_WORLD);
-    }
-
-    // Recibir los datos correspondientes a la distribución cíclica
-    int recv_count = 0;
-    for (int i = 0; i < cyclic_size; i++) {
-        MPI_Status status;
-        if (rank + i * size < n) {
-            MPI_Recv(&cyclic_part[i], 1, MPI_INT, MPI_ANY_SOURCE, i, MPI_COMM_WORLD, &status);
-            recv_count++;
-        }
-    }
+    int *block_part_back = (int*) malloc(block_size * sizeof(int));
+    redistribucion r = {rank, size, n, block_size, cyclic_size, 0,
+                        block_part, cyclic_part, block_part_back};
+    bench_config cfg = bench_config_entorno();
+    bench_stats s;
 
-    end = MPI_Wtime();
+    s = bench_repetir("redistrib/block_a_cyclic", &cfg, muestra_block_a_cyclic, &r);
     if (rank == 0) {
-        printf("Tiempo BLOCK -> CYCLIC: %f segundos\n", end - start);
+        printf("Tiempo BLOCK -> CYCLIC: %f segundos\n", s.mediana);
+        bench_reportar(&cfg, &s);
     }
 
     // -------------------------------
     // CYCLIC -> BLOCK
     // -------------------------------
-    int *block_part_back = (int*) malloc(block_size * sizeof(int));
-
-    start = MPI_Wtime();
-
-    for (int i = 0; i < recv_count; i++) {
-        int global_index = i * size + rank;
-        int target_proc = global_index / block_size;
-        int pos_in_target = global_index % block_size;
-        MPI_Send(&cyclic_part[i], 1, MPI_INT, target_proc, pos_in_target, MPI_COMM_WORLD);
-    }
-
-    for (int i = 0; i < block_size; i++) {
-        MPI_Status status;
-        MPI_Recv(&block_part_back[i], 1, MPI_INT, MPI_ANY_SOURCE, i, MPI_COMM_WORLD, &status);
-    }
-
-    end = MPI_Wtime();
+    s = bench_repetir("redistrib/cyclic_a_block", &cfg, muestra_cyclic_a_block, &r);
     if (rank == 0) {
-        printf("Tiempo CYCLIC -> BLOCK: %f segundos\n\n", end - start);
+        printf("Tiempo CYCLIC -> BLOCK: %f segundos\n", s.mediana);
+        bench_reportar(&cfg, &s);
+        printf("\n");
     }
+    bench_config_cerrar(&cfg);
 
     // -------------------------------
     // PROCESO 0: Recolectar y mostrar
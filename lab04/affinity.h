@@ -0,0 +1,241 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Afinidad de los workers de lab04 y consultas NUMA sin libnuma.
+//
+// LAB04_AFINIDAD elige donde corre el worker i:
+// - "ninguna" (por defecto): el scheduler decide, como antes.
+// - "compacta": CPUs en orden nodo, socket, nucleo; llena un nodo antes de
+//   pasar al siguiente (los hermanos SMT quedan juntos).
+// - "dispersa": de a una CPU por nodo en ronda, y dentro del nodo un nucleo
+//   fisico distinto antes de repetir hermanos SMT.
+// - una lista "0,2,8-11": el worker i va a la CPU i de la lista.
+// Con mas workers que CPUs la lista se recorre de nuevo desde el principio.
+//
+// El nodo de una CPU sale de /sys/devices/system/node; el nodo donde corre un
+// thread (getcpu) y el de una pagina (get_mempolicy) se piden con syscall()
+// directo, asi no hace falta libnuma instalada.
+
+struct CpuInfo {
+    int cpu;
+    int node;
+    int package;
+    int core;
+    int sibling;    // orden entre los hermanos SMT del mismo nucleo
+};
+
+class Affinity {
+private:
+    // get_mempolicy(2): con MPOL_F_NODE | MPOL_F_ADDR devuelve el nodo de la
+    // pagina que contiene addr
+    static const unsigned long MPOL_F_NODE_FLAG = 1;
+    static const unsigned long MPOL_F_ADDR_FLAG = 2;
+
+    static int readInt(const char* path, int fallback) {
+        FILE* f = fopen(path, "r");
+        if (f == nullptr) return fallback;
+        int value;
+        if (fscanf(f, "%d", &value) != 1) value = fallback;
+        fclose(f);
+        return value;
+    }
+
+    // "0-3,8,10-11" -> {0,1,2,3,8,10,11}; false si el formato no es valido
+    static bool parseCpuList(const char* text, std::vector<int>& cpus) {
+        const char* p = text;
+        while (*p != '\0' && *p != '\n') {
+            char* end;
+            long first = strtol(p, &end, 10);
+            if (end == p || first < 0) return false;
+            long last = first;
+            p = end;
+            if (*p == '-') {
+                last = strtol(p + 1, &end, 10);
+                if (end == p + 1 || last < first) return false;
+                p = end;
+            }
+            for (long c = first; c <= last; c++) cpus.push_back((int)c);
+            if (*p == ',') p++;
+            else if (*p != '\0' && *p != '\n') return false;
+        }
+        return !cpus.empty();
+    }
+
+public:
+    // CPUs en las que el proceso puede correr, con su nodo y nucleo
+    static std::vector<CpuInfo> allowedCpus() {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+            for (int c = 0; c < (int)sysconf(_SC_NPROCESSORS_ONLN); c++) CPU_SET(c, &set);
+        }
+
+        std::vector<int> nodeOf(CPU_SETSIZE, 0);
+        char path[128];
+        for (int node = 0; node < numaNodes(); node++) {
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+            FILE* f = fopen(path, "r");
+            if (f == nullptr) continue;
+            char line[4096];
+            std::vector<int> cpus;
+            if (fgets(line, sizeof(line), f) != nullptr && parseCpuList(line, cpus)) {
+                for (int c : cpus) {
+                    if (c < CPU_SETSIZE) nodeOf[c] = node;
+                }
+            }
+            fclose(f);
+        }
+
+        std::vector<CpuInfo> result;
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (!CPU_ISSET(c, &set)) continue;
+            CpuInfo info;
+            info.cpu = c;
+            info.node = nodeOf[c];
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", c);
+            info.package = readInt(path, 0);
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", c);
+            info.core = readInt(path, c);
+            info.sibling = 0;
+            for (const CpuInfo& prev : result) {
+                if (prev.package == info.package && prev.core == info.core) info.sibling++;
+            }
+            result.push_back(info);
+        }
+        return result;
+    }
+
+    // Nodos con nombre nodeN en /sys (1 si no hay informacion NUMA)
+    static int numaNodes() {
+        static int cached = 0;
+        if (cached == 0) {
+            char line[4096];
+            std::vector<int> nodes;
+            FILE* f = fopen("/sys/devices/system/node/possible", "r");
+            if (f != nullptr) {
+                if (fgets(line, sizeof(line), f) != nullptr) parseCpuList(line, nodes);
+                fclose(f);
+            }
+            cached = nodes.empty() ? 1 : *std::max_element(nodes.begin(), nodes.end()) + 1;
+        }
+        return cached;
+    }
+
+    // CPU por worker segun 'spec' (ver arriba). Vacio = sin fijar; en 'error'
+    // queda el motivo si spec no se entiende.
+    static std::vector<int> workerCpus(const char* spec, int workers, std::string& error) {
+        std::vector<int> order;
+        if (spec == nullptr || spec[0] == '\0' || strcmp(spec, "ninguna") == 0) return order;
+
+        std::vector<CpuInfo> cpus = allowedCpus();
+        if (strcmp(spec, "compacta") == 0 || strcmp(spec, "dispersa") == 0) {
+            std::sort(cpus.begin(), cpus.end(), [](const CpuInfo& a, const CpuInfo& b) {
+                if (a.node != b.node) return a.node < b.node;
+                if (a.package != b.package) return a.package < b.package;
+                if (a.core != b.core) return a.core < b.core;
+                return a.cpu < b.cpu;
+            });
+            if (strcmp(spec, "dispersa") == 0) {
+                // primero todos los nucleos fisicos, despues sus hermanos SMT;
+                // dentro de cada vuelta, de a un nodo por vez
+                std::stable_sort(cpus.begin(), cpus.end(), [](const CpuInfo& a, const CpuInfo& b) {
+                    return a.sibling < b.sibling;
+                });
+                std::vector<std::vector<CpuInfo>> perNode(numaNodes());
+                for (const CpuInfo& c : cpus) perNode[std::min(c.node, numaNodes() - 1)].push_back(c);
+                cpus.clear();
+                for (size_t i = 0; ; i++) {
+                    bool any = false;
+                    for (std::vector<CpuInfo>& list : perNode) {
+                        if (i < list.size()) {
+                            cpus.push_back(list[i]);
+                            any = true;
+                        }
+                    }
+                    if (!any) break;
+                }
+            }
+            for (const CpuInfo& c : cpus) order.push_back(c.cpu);
+        } else if (!parseCpuList(spec, order)) {
+            error = std::string("LAB04_AFINIDAD invalida: ") + spec +
+                    " (ninguna, compacta, dispersa o lista como 0,2,4-7)";
+            order.clear();
+            return order;
+        }
+
+        if (order.empty()) return order;
+        std::vector<int> result(workers);
+        for (int i = 0; i < workers; i++) result[i] = order[i % order.size()];
+        return result;
+    }
+
+    static std::string policyName() {
+        const char* spec = getenv("LAB04_AFINIDAD");
+        return (spec == nullptr || spec[0] == '\0') ? "ninguna" : spec;
+    }
+
+    // Fija los workers de 'pool' (ThreadPool o cualquiera con size() y
+    // pinWorker(i, cpu)) segun LAB04_AFINIDAD; devuelve la politica aplicada
+    template <class Pool>
+    static std::string pinPool(Pool& pool) {
+        const char* spec = getenv("LAB04_AFINIDAD");
+        std::string error;
+        std::vector<int> cpus = workerCpus(spec, pool.size(), error);
+        if (!error.empty()) {
+            fprintf(stderr, "%s\n", error.c_str());
+        }
+        if (cpus.empty()) return "ninguna";
+
+        std::string description = spec;
+        description += " (cpus";
+        for (int i = 0; i < pool.size(); i++) {
+            if (!pool.pinWorker(i, cpus[i])) {
+                fprintf(stderr, "no se pudo fijar el worker %d a la cpu %d\n", i, cpus[i]);
+            }
+            description += " " + std::to_string(cpus[i]);
+        }
+        return description + ")";
+    }
+
+    static bool pinThread(pthread_t thread, int cpu) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+    }
+
+    // CPU y nodo del thread que llama (getcpu(2)); -1 si no se sabe
+    static int currentCpu(int* node) {
+        unsigned cpu = 0, n = 0;
+        if (syscall(SYS_getcpu, &cpu, &n, nullptr) != 0) {
+            *node = -1;
+            return -1;
+        }
+        *node = (int)n;
+        return (int)cpu;
+    }
+
+    // Nodo donde esta la pagina de 'addr'; -1 si el kernel no lo informa
+    // (sin NUMA, o get_mempolicy bloqueado en un contenedor)
+    static int pageNode(const void* addr) {
+        int node = -1;
+        if (syscall(SYS_get_mempolicy, &node, nullptr, 0UL, addr,
+                    MPOL_F_NODE_FLAG | MPOL_F_ADDR_FLAG) != 0) {
+            return -1;
+        }
+        return node;
+    }
+};
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <cstdint>
+#include <cstdlib>
+
+// Generador por contador para los datos de lab04 (Philox4x32-10 de Salmon,
+// Moraes, Dror y Shaw, "Parallel random numbers: as easy as 1, 2, 3").
+//
+// No hay estado que avanzar: el bloque numero n de la secuencia 's' es una
+// funcion pura de (semilla, s, n), 10 rondas de multiplicar y mezclar sobre
+// un contador de 128 bits. Cualquier thread calcula el elemento que le toca
+// sin haber generado los anteriores, asi que llenar una matriz en paralelo da
+// los mismos bits con 1 o con 8 threads, y cada worker de la lista tiene su
+// propia secuencia con solo cambiar 's'.
+//
+// - CounterRng::uniformAt(i): el double numero i de la secuencia, en [0, 1).
+// - fillUniform(dst, first, count, lo, hi): dst[k] = elemento first + k
+//   llevado a [lo, hi); dos doubles por bloque de Philox.
+// - next32 / nextUniform / nextBelow: uso secuencial (un worker que consume
+//   su secuencia en orden), con un bloque de 4 palabras en buffer.
+//
+// La semilla sale de LAB04_SEMILLA (por defecto 1): la misma semilla repite la
+// corrida bit a bit.
+
+struct PhiloxBlock {
+    uint32_t v[4];
+};
+
+static inline PhiloxBlock philox4x32(uint64_t counterLo, uint64_t counterHi, uint64_t key) {
+    const uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+    const uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+    uint32_t c0 = (uint32_t)counterLo, c1 = (uint32_t)(counterLo >> 32);
+    uint32_t c2 = (uint32_t)counterHi, c3 = (uint32_t)(counterHi >> 32);
+    uint32_t k0 = (uint32_t)key, k1 = (uint32_t)(key >> 32);
+    for (int round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t)M0 * c0;
+        uint64_t p1 = (uint64_t)M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += W0;
+        k1 += W1;
+    }
+    PhiloxBlock b = {{c0, c1, c2, c3}};
+    return b;
+}
+
+// 53 bits de (hi, lo) -> [0, 1)
+static inline double philoxUnit(uint32_t hi, uint32_t lo) {
+    uint64_t bits = (((uint64_t)hi << 32) | lo) >> 11;
+    return (double)bits * (1.0 / 9007199254740992.0);
+}
+
+class CounterRng {
+private:
+    uint64_t key;
+    uint64_t stream;
+    uint64_t position;      // proximo bloque para el uso secuencial
+    PhiloxBlock buffer;
+    int used;               // palabras de 'buffer' ya entregadas
+
+public:
+    CounterRng(uint64_t seed, uint64_t streamId)
+        : key(seed), stream(streamId), position(0), buffer(), used(4) {}
+
+    static uint64_t seedFromEnv() {
+        const char* text = getenv("LAB04_SEMILLA");
+        if (text == nullptr || text[0] == '\0') return 1;
+        return strtoull(text, nullptr, 0);
+    }
+
+    PhiloxBlock block(uint64_t index) const {
+        return philox4x32(index, stream, key);
+    }
+
+    double uniformAt(uint64_t index) const {
+        PhiloxBlock b = block(index >> 1);
+        return (index & 1) ? philoxUnit(b.v[2], b.v[3]) : philoxUnit(b.v[0], b.v[1]);
+    }
+
+    void fillUniform(double* dst, uint64_t first, size_t count, double lo, double hi) const {
+        double width = hi - lo;
+        size_t k = 0;
+        if ((first & 1) && count > 0) {
+            dst[k++] = lo + width * uniformAt(first);
+        }
+        for (; k + 2 <= count; k += 2) {
+            PhiloxBlock b = block((first + k) >> 1);
+            dst[k] = lo + width * philoxUnit(b.v[0], b.v[1]);
+            dst[k + 1] = lo + width * philoxUnit(b.v[2], b.v[3]);
+        }
+        if (k < count) {
+            dst[k] = lo + width * uniformAt(first + k);
+        }
+    }
+
+    uint32_t next32() {
+        if (used == 4) {
+            buffer = block(position++);
+            used = 0;
+        }
+        return buffer.v[used++];
+    }
+
+    double nextUniform() {
+        uint32_t hi = next32();
+        return philoxUnit(hi, next32());
+    }
+
+    // [0, n) por multiplicacion (Lemire); el sesgo es < n / 2^32
+    uint32_t nextBelow(uint32_t n) {
+        return (uint32_t)(((uint64_t)next32() * n) >> 32);
+    }
+};
+
+#endif
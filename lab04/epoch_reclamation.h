@@ -0,0 +1,114 @@
+#ifndef EPOCH_RECLAMATION_H
+#define EPOCH_RECLAMATION_H
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+// Reclamacion por epocas (Fraser, "Practical lock-freedom", 2004) para las
+// listas de lab04 que se recorren sin locks.
+//
+// Un nodo que se saca de la lista no se puede liberar en el momento: otro
+// thread puede estar parado sobre el. Cada operacion corre entre enter(id) y
+// exit(id); enter anota que el thread esta activo y la epoca global que vio.
+//
+// - retire(id, p): p ya no es alcanzable desde la lista. Se guarda con la
+//   epoca global leida despues de sacarlo (e): solo pueden tenerlo los
+//   threads que entraron antes, con epoca local <= e.
+// - La epoca global pasa de g a g+1 solo cuando todos los threads activos
+//   vieron g. Para llegar a e+2 todos los activos tuvieron que ver e+1, asi
+//   que los que entraron con epoca <= e ya salieron: p se libera cuando la
+//   epoca global llega a e+2.
+// - Cada thread guarda lo suyo en una cola en orden de epoca y libera desde
+//   el frente; cada RETIRE_BATCH retiros intenta avanzar la epoca.
+//
+// Si un thread se queda dentro de una operacion la epoca no avanza y la
+// memoria pendiente crece, pero nunca se libera algo en uso.
+
+template <class Node>
+class EpochReclaimer {
+private:
+    static const int RETIRE_BATCH = 64;
+
+    struct Retired {
+        unsigned long epoch;
+        Node* node;
+    };
+
+    // estado = (epoca << 1) | activo, en una sola palabra para que enter lo
+    // publique con un solo store
+    struct alignas(64) ThreadRecord {
+        std::atomic<unsigned long> state;
+        std::deque<Retired> retired;
+        int sinceAdvance;
+    };
+
+    alignas(64) std::atomic<unsigned long> globalEpoch;
+    std::vector<ThreadRecord> records;
+
+    bool tryAdvance(unsigned long epoch) {
+        for (ThreadRecord& r : records) {
+            unsigned long s = r.state.load(std::memory_order_seq_cst);
+            if ((s & 1) && (s >> 1) != epoch) return false;
+        }
+        return globalEpoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    }
+
+    void collect(ThreadRecord& r) {
+        unsigned long epoch = globalEpoch.load(std::memory_order_acquire);
+        while (!r.retired.empty() && r.retired.front().epoch + 2 <= epoch) {
+            delete r.retired.front().node;
+            r.retired.pop_front();
+        }
+    }
+
+public:
+    EpochReclaimer(int threads) : globalEpoch(0), records(threads) {
+        for (ThreadRecord& r : records) {
+            r.state.store(0, std::memory_order_relaxed);
+            r.sinceAdvance = 0;
+        }
+    }
+
+    ~EpochReclaimer() { reclaimAll(); }
+
+    void enter(int id) {
+        unsigned long epoch = globalEpoch.load(std::memory_order_seq_cst);
+        records[id].state.store((epoch << 1) | 1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void exit(int id) {
+        records[id].state.store(records[id].state.load(std::memory_order_relaxed) & ~1UL,
+                                std::memory_order_release);
+    }
+
+    // Llamar dentro de enter/exit, una sola vez por nodo
+    void retire(int id, Node* node) {
+        ThreadRecord& r = records[id];
+        r.retired.push_back({globalEpoch.load(std::memory_order_seq_cst), node});
+        if (++r.sinceAdvance >= RETIRE_BATCH) {
+            r.sinceAdvance = 0;
+            tryAdvance(globalEpoch.load(std::memory_order_seq_cst));
+            collect(r);
+        }
+    }
+
+    // Nodos retirados que todavia no se liberaron
+    size_t pending() const {
+        size_t total = 0;
+        for (const ThreadRecord& r : records) total += r.retired.size();
+        return total;
+    }
+
+    // Libera todo lo retirado; solo sin threads dentro de una operacion
+    void reclaimAll() {
+        for (ThreadRecord& r : records) {
+            for (const Retired& item : r.retired) delete item.node;
+            r.retired.clear();
+            r.sinceAdvance = 0;
+        }
+    }
+};
+
+#endif
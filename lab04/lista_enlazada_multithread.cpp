@@ -1,14 +1,19 @@
 #include <iostream>
 #include <pthread.h>
-#include <chrono>
-#include <random>
 #include <vector>
 #include <cstdlib>
 #include <unistd.h>
 #include <iomanip>
+#include <atomic>
+#include <cstdint>
+#include <climits>
+
+#include "../comun/benchmark.h"
+#include "thread_pool.h"
+#include "counter_rng.h"
+#include "epoch_reclamation.h"
 
 using namespace std;
-using namespace std::chrono;
 
 // estructuras para los diferentes tipos de nodos
 struct list_node_s {
@@ -30,9 +35,39 @@ struct list_node_with_mutex_s {
     }
 };
 
+// nodo de la lista sin locks: el bit bajo de next marca el nodo como borrado
+// (borrado logico); despues se lo desengancha con un CAS sobre el anterior
+struct list_node_lf_s {
+    int data;
+    atomic<uintptr_t> next;
+    
+    list_node_lf_s(int value) : data(value), next(0) {}
+};
+
+// nodo de la lista perezosa: marked es el borrado logico, se pone con los
+// mutex de pred y curr tomados y antes de desenganchar el nodo
+struct list_node_lazy_s {
+    int data;
+    atomic<struct list_node_lazy_s*> next;
+    atomic<bool> marked;
+    pthread_mutex_t mutex;
+    
+    list_node_lazy_s(int value, struct list_node_lazy_s* succ) : data(value), next(succ), marked(false) {
+        pthread_mutex_init(&mutex, nullptr);
+    }
+    
+    ~list_node_lazy_s() {
+        pthread_mutex_destroy(&mutex);
+    }
+};
+
 // variables globales
 struct list_node_s* head_p = nullptr;
 struct list_node_with_mutex_s* head_per_node = nullptr;
+atomic<uintptr_t> head_lf(0);
+EpochReclaimer<list_node_lf_s>* reclaimer_lf;   // un registro por worker del pool
+struct list_node_lazy_s* head_lazy = nullptr;   // centinelas INT_MIN ... INT_MAX
+EpochReclaimer<list_node_lazy_s>* reclaimer_lazy;
 
 pthread_rwlock_t list_rwlock = PTHREAD_RWLOCK_INITIALIZER;
 pthread_mutex_t list_mutex = PTHREAD_MUTEX_INITIALIZER;
@@ -40,7 +75,9 @@ pthread_mutex_t head_per_node_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 int thread_count;
 int num_ops_per_thread;
-int implementation_type; // 1=rwlock, 2=single_mutex, 3=per_node_mutex
+int implementation_type; // 1=rwlock, 2=single_mutex, 3=per_node_mutex, 4=lock_free, 5=lazy
+ThreadPool* pool;        // workers persistentes, creados una vez en main
+uint64_t rng_seed;       // LAB04_SEMILLA: el thread k usa la secuencia k de CounterRng
 
 //  implementacion 1: read-write locks 
 
@@ -322,6 +359,209 @@ int Delete_PerNodeMutex(int value) {
     }
 }
 
+// ==================== implementacion 4: sin locks (Harris-Michael) ====================
+// Insert y Delete con CAS sobre next; Delete primero marca el next del nodo
+// (nadie puede enlazar detras de un nodo marcado) y despues lo saca. Member
+// recorre sin escribir nada y sin reintentos. Los nodos que se sacan se
+// liberan con reclamacion por epocas: cada operacion va entre enter y exit
+// del thread 'rank'.
+
+static inline struct list_node_lf_s* Lf_ptr(uintptr_t link) {
+    return (struct list_node_lf_s*)(link & ~(uintptr_t)1);
+}
+
+static inline bool Lf_marked(uintptr_t link) {
+    return (link & 1) != 0;
+}
+
+// Deja en curr el primer nodo no marcado con data >= value y en prev el
+// puntero que lo enlaza; desengancha los nodos marcados que encuentra
+// (Michael 2002). Devuelve si curr tiene value.
+static bool Find_LockFree(int value, atomic<uintptr_t>*& prev, struct list_node_lf_s*& curr, int rank) {
+    while (true) {
+        prev = &head_lf;
+        curr = Lf_ptr(prev->load(memory_order_acquire));
+        bool restart = false;
+        while (curr != nullptr) {
+            uintptr_t next = curr->next.load(memory_order_acquire);
+            if (Lf_marked(next)) {
+                uintptr_t expected = (uintptr_t)curr;
+                if (!prev->compare_exchange_strong(expected, next & ~(uintptr_t)1)) {
+                    restart = true;
+                    break;
+                }
+                reclaimer_lf->retire(rank, curr);
+                curr = Lf_ptr(next);
+                continue;
+            }
+            // curr seguia enganchado cuando se leyo su next
+            if (prev->load(memory_order_acquire) != (uintptr_t)curr) {
+                restart = true;
+                break;
+            }
+            if (curr->data >= value) {
+                return curr->data == value;
+            }
+            prev = &curr->next;
+            curr = Lf_ptr(next);
+        }
+        if (!restart) return false;
+    }
+}
+
+int Member_LockFree(int value, int rank) {
+    reclaimer_lf->enter(rank);
+    struct list_node_lf_s* temp_p = Lf_ptr(head_lf.load(memory_order_acquire));
+    while (temp_p != nullptr && temp_p->data < value) {
+        temp_p = Lf_ptr(temp_p->next.load(memory_order_acquire));
+    }
+    
+    int result = 0;
+    if (temp_p != nullptr && temp_p->data == value && !Lf_marked(temp_p->next.load(memory_order_acquire))) {
+        result = 1;
+    }
+    reclaimer_lf->exit(rank);
+    return result;
+}
+
+int Insert_LockFree(int value, int rank) {
+    atomic<uintptr_t>* prev;
+    struct list_node_lf_s* curr_p;
+    struct list_node_lf_s* temp_p = nullptr;
+    
+    reclaimer_lf->enter(rank);
+    while (true) {
+        if (Find_LockFree(value, prev, curr_p, rank)) {
+            reclaimer_lf->exit(rank);
+            delete temp_p;
+            return 0;
+        }
+        if (temp_p == nullptr) {
+            temp_p = new list_node_lf_s(value);
+        }
+        temp_p->next.store((uintptr_t)curr_p, memory_order_relaxed);
+        uintptr_t expected = (uintptr_t)curr_p;
+        if (prev->compare_exchange_strong(expected, (uintptr_t)temp_p)) {
+            reclaimer_lf->exit(rank);
+            return 1;
+        }
+    }
+}
+
+int Delete_LockFree(int value, int rank) {
+    atomic<uintptr_t>* prev;
+    struct list_node_lf_s* curr_p;
+    
+    reclaimer_lf->enter(rank);
+    while (true) {
+        if (!Find_LockFree(value, prev, curr_p, rank)) {
+            reclaimer_lf->exit(rank);
+            return 0;
+        }
+        uintptr_t next = curr_p->next.load(memory_order_acquire);
+        if (Lf_marked(next) || !curr_p->next.compare_exchange_strong(next, next | 1)) {
+            continue;
+        }
+        // borrado logico hecho; si otro cambio prev, el Find lo desengancha
+        uintptr_t expected = (uintptr_t)curr_p;
+        if (prev->compare_exchange_strong(expected, next)) {
+            reclaimer_lf->retire(rank, curr_p);
+        } else {
+            Find_LockFree(value, prev, curr_p, rank);
+        }
+        reclaimer_lf->exit(rank);
+        return 1;
+    }
+}
+
+// ==================== implementacion 5: lista perezosa (Heller et al.) ====================
+// El recorrido no toma locks; Insert y Delete toman solo los mutex de pred y
+// curr en el punto a cambiar y validan que ninguno este borrado y que pred
+// siga apuntando a curr (si no, recorren de nuevo). Member no toma ningun
+// lock: alcanza con mirar marked del nodo donde termina. Los centinelas
+// evitan los casos de lista vacia y de cabeza; los nodos sacados se liberan
+// por epocas porque un recorrido puede estar pasando por ellos.
+
+static inline bool Validate_Lazy(struct list_node_lazy_s* pred, struct list_node_lazy_s* curr) {
+    return !pred->marked.load(memory_order_acquire) && !curr->marked.load(memory_order_acquire) &&
+           pred->next.load(memory_order_acquire) == curr;
+}
+
+// Deja pred y curr con pred->data < value <= curr->data, sin locks
+static inline void Locate_Lazy(int value, struct list_node_lazy_s*& pred, struct list_node_lazy_s*& curr) {
+    pred = head_lazy;
+    curr = pred->next.load(memory_order_acquire);
+    while (curr->data < value) {
+        pred = curr;
+        curr = curr->next.load(memory_order_acquire);
+    }
+}
+
+int Member_Lazy(int value, int rank) {
+    reclaimer_lazy->enter(rank);
+    struct list_node_lazy_s* temp_p = head_lazy;
+    while (temp_p->data < value) {
+        temp_p = temp_p->next.load(memory_order_acquire);
+    }
+    int result = (temp_p->data == value && !temp_p->marked.load(memory_order_acquire)) ? 1 : 0;
+    reclaimer_lazy->exit(rank);
+    return result;
+}
+
+int Insert_Lazy(int value, int rank) {
+    struct list_node_lazy_s* pred_p;
+    struct list_node_lazy_s* curr_p;
+    
+    reclaimer_lazy->enter(rank);
+    while (true) {
+        Locate_Lazy(value, pred_p, curr_p);
+        pthread_mutex_lock(&(pred_p->mutex));
+        pthread_mutex_lock(&(curr_p->mutex));
+        if (Validate_Lazy(pred_p, curr_p)) {
+            int result = 0;
+            if (curr_p->data != value) {
+                pred_p->next.store(new list_node_lazy_s(value, curr_p), memory_order_release);
+                result = 1;
+            }
+            pthread_mutex_unlock(&(curr_p->mutex));
+            pthread_mutex_unlock(&(pred_p->mutex));
+            reclaimer_lazy->exit(rank);
+            return result;
+        }
+        pthread_mutex_unlock(&(curr_p->mutex));
+        pthread_mutex_unlock(&(pred_p->mutex));
+    }
+}
+
+int Delete_Lazy(int value, int rank) {
+    struct list_node_lazy_s* pred_p;
+    struct list_node_lazy_s* curr_p;
+    
+    reclaimer_lazy->enter(rank);
+    while (true) {
+        Locate_Lazy(value, pred_p, curr_p);
+        pthread_mutex_lock(&(pred_p->mutex));
+        pthread_mutex_lock(&(curr_p->mutex));
+        if (Validate_Lazy(pred_p, curr_p)) {
+            int result = 0;
+            if (curr_p->data == value) {
+                curr_p->marked.store(true, memory_order_release);
+                pred_p->next.store(curr_p->next.load(memory_order_relaxed), memory_order_release);
+                result = 1;
+            }
+            pthread_mutex_unlock(&(curr_p->mutex));
+            pthread_mutex_unlock(&(pred_p->mutex));
+            if (result) {
+                reclaimer_lazy->retire(rank, curr_p);
+            }
+            reclaimer_lazy->exit(rank);
+            return result;
+        }
+        pthread_mutex_unlock(&(curr_p->mutex));
+        pthread_mutex_unlock(&(pred_p->mutex));
+    }
+}
+
 //  funciones de inicializacion 
 
 void Initialize_RWLock_List() {
@@ -369,51 +609,107 @@ void Initialize_PerNodeMutex_List() {
     }
 }
 
+// sin threads corriendo: se libera la lista y lo que quedo retirado
+void Clear_LockFree_List() {
+    struct list_node_lf_s* temp = Lf_ptr(head_lf.load());
+    while (temp != nullptr) {
+        struct list_node_lf_s* next = Lf_ptr(temp->next.load());
+        delete temp;
+        temp = next;
+    }
+    head_lf.store(0);
+    reclaimer_lf->reclaimAll();
+}
+
+void Initialize_LockFree_List() {
+    Clear_LockFree_List();
+    
+    // insertar algunos valores iniciales
+    for (int i = 0; i < 1000; i++) {
+        Insert_LockFree(i * 2, 0);
+    }
+}
+
+// sin threads corriendo: se libera la lista (centinelas incluidos) y lo retirado
+void Clear_Lazy_List() {
+    struct list_node_lazy_s* temp = head_lazy;
+    while (temp != nullptr) {
+        struct list_node_lazy_s* next = temp->next.load();
+        delete temp;
+        temp = next;
+    }
+    head_lazy = nullptr;
+    reclaimer_lazy->reclaimAll();
+}
+
+void Initialize_Lazy_List() {
+    Clear_Lazy_List();
+    head_lazy = new list_node_lazy_s(INT_MIN, new list_node_lazy_s(INT_MAX, nullptr));
+    
+    // insertar algunos valores iniciales
+    for (int i = 0; i < 1000; i++) {
+        Insert_Lazy(i * 2, 0);
+    }
+}
+
 //  funcion de trabajo de los threads 
 
 void* Thread_work(void* rank) {
     long my_rank = (long) rank;
     int i, val;
+    long found = 0;
     double which_op;
     
-    // generador de numeros aleatorios por thread
-    random_device rd;
-    mt19937 gen(rd() + my_rank);
-    uniform_real_distribution<double> op_dist(0.0, 1.0);
-    uniform_int_distribution<int> val_dist(0, 99999);
+    // secuencia propia de cada thread: las mismas operaciones en cada
+    // repeticion y en cada implementacion para una semilla dada
+    CounterRng gen(rng_seed, my_rank);
     
     for (i = 0; i < num_ops_per_thread; i++) {
-        which_op = op_dist(gen);
-        val = val_dist(gen);
+        which_op = gen.nextUniform();
+        val = gen.nextBelow(100000);
         
         if (which_op < 0.999) { // 99.9% member operations
             if (implementation_type == 1) {
-                Member_RWLock(val);
+                found += Member_RWLock(val);
             } else if (implementation_type == 2) {
-                Member_SingleMutex(val);
+                found += Member_SingleMutex(val);
+            } else if (implementation_type == 3) {
+                found += Member_PerNodeMutex(val);
+            } else if (implementation_type == 4) {
+                found += Member_LockFree(val, my_rank);
             } else {
-                Member_PerNodeMutex(val);
+                found += Member_Lazy(val, my_rank);
             }
         } else if (which_op < 0.9995) { // 0.05% insert operations
             if (implementation_type == 1) {
                 Insert_RWLock(val);
             } else if (implementation_type == 2) {
                 Insert_SingleMutex(val);
-            } else {
+            } else if (implementation_type == 3) {
                 Insert_PerNodeMutex(val);
+            } else if (implementation_type == 4) {
+                Insert_LockFree(val, my_rank);
+            } else {
+                Insert_Lazy(val, my_rank);
             }
         } else { // 0.05% delete operations
             if (implementation_type == 1) {
                 Delete_RWLock(val);
             } else if (implementation_type == 2) {
                 Delete_SingleMutex(val);
-            } else {
+            } else if (implementation_type == 3) {
                 Delete_PerNodeMutex(val);
+            } else if (implementation_type == 4) {
+                Delete_LockFree(val, my_rank);
+            } else {
+                Delete_Lazy(val, my_rank);
             }
         }
     }
     
-    return nullptr;
+    // se devuelve cuantos member encontraron el valor: sin usar el resultado,
+    // el compilador puede borrar los recorridos que no escriben nada
+    return (void*) found;
 }
 
 //  funcion principal 
@@ -423,35 +719,48 @@ double RunTest(int impl_type, int threads, int ops) {
     thread_count = threads;
     num_ops_per_thread = ops;
     
-    pthread_t* thread_handles = new pthread_t[thread_count];
-    
     // inicializar la lista apropiada
     if (impl_type == 1) {
         Initialize_RWLock_List();
     } else if (impl_type == 2) {
         Initialize_SingleMutex_List();
-    } else {
+    } else if (impl_type == 3) {
         Initialize_PerNodeMutex_List();
+    } else if (impl_type == 4) {
+        Initialize_LockFree_List();
+    } else {
+        Initialize_Lazy_List();
     }
     
-    auto start_time = high_resolution_clock::now();
-    
-    // crear threads
-    for (long thread = 0; thread < thread_count; thread++) {
-        pthread_create(&thread_handles[thread], nullptr, Thread_work, (void*) thread);
-    }
-    
-    // esperar que terminen todos los threads
+    vector<void*> ranks(thread_count);
     for (long thread = 0; thread < thread_count; thread++) {
-        pthread_join(thread_handles[thread], nullptr);
+        ranks[thread] = (void*) thread;
     }
     
-    auto end_time = high_resolution_clock::now();
-    auto duration = duration_cast<milliseconds>(end_time - start_time);
-    
-    delete[] thread_handles;
-    
-    return duration.count() / 1000.0; // retornar en segundos
+    // segundos de reloj de pared entre las barreras de arranque y fin del pool
+    return pool->runParallel(thread_count, Thread_work, ranks.data());
+}
+
+//  medicion repetida con el arnes comun 
+
+struct test_params {
+    int impl_type;
+    int threads;
+    int ops;
+};
+
+double Test_sample(void* arg) {
+    test_params* p = (test_params*) arg;
+    return RunTest(p->impl_type, p->threads, p->ops);
+}
+
+// cada repeticion reconstruye la lista, asi que todas parten del mismo estado
+bench_stats BenchmarkTest(const bench_config* cfg, const char* impl_name,
+                          int impl_type, int threads, int ops) {
+    char name[BENCH_MAX_NOMBRE];
+    snprintf(name, sizeof(name), "lista/%s/t=%d/ops=%d", impl_name, threads, ops);
+    test_params params = {impl_type, threads, ops};
+    return bench_repetir(name, cfg, Test_sample, &params);
 }
 
 int main(int argc, char* argv[]) {
@@ -462,51 +771,87 @@ int main(int argc, char* argv[]) {
     }
     
     int ops_per_thread = strtol(argv[1], nullptr, 10);
-    int thread_counts[] = {1, 2, 4, 8};
-    int num_thread_counts = 4;
+    // 1, 2, 4, ... hasta LISTA_MAX_THREADS (incluido aunque no sea potencia de 2)
+    int max_threads = bench_entero_entorno("LISTA_MAX_THREADS", 16, 1);
+    vector<int> thread_counts;
+    for (int t = 1; t < max_threads; t *= 2) {
+        thread_counts.push_back(t);
+    }
+    thread_counts.push_back(max_threads);
+    int num_thread_counts = thread_counts.size();
+    bench_config cfg = bench_config_entorno();
+    vector<bench_stats> records;
+    pool = new ThreadPool(max_threads);
+    reclaimer_lf = new EpochReclaimer<list_node_lf_s>(max_threads);
+    reclaimer_lazy = new EpochReclaimer<list_node_lazy_s>(max_threads);
+    string affinity = Affinity::pinPool(*pool);
+    rng_seed = CounterRng::seedFromEnv();
     
     cout << "\n=== analisis de rendimiento - lista enlazada multi-thread ===" << endl;
     cout << "operaciones por thread: " << ops_per_thread << endl;
+    cout << "afinidad (LAB04_AFINIDAD): " << affinity << endl;
+    cout << "semilla (LAB04_SEMILLA): " << rng_seed << endl;
     cout << "distribucion: 99.9% member, 0.05% insert, 0.05% delete" << endl;
     cout << "\n";
     
+    struct list_impl {
+        const char* label;
+        const char* record;
+        int type;
+    };
+    list_impl impls[] = {
+        {"Read-Write Locks", "rwlock", 1},
+        {"One Mutex for Entire List", "mutex_global", 2},
+        {"One Mutex per Node", "mutex_por_nodo", 3},
+        {"Lock-Free (Harris-Michael)", "sin_locks", 4},
+        {"Lazy List (Heller et al.)", "perezosa", 5}
+    };
+    
     // crear tabla de resultados
-    cout << "=====================================================================" << endl;
-    cout << "|                             |      Number of Threads       |" << endl;
-    cout << "|-----------------------------|-------------------------------|" << endl;
-    cout << "|        Implementation       |    1    |    2    |    4    |    8    |" << endl;
-    cout << "|-----------------------------|---------|---------|---------|---------|" << endl;
-    
-    // ejecutar pruebas para read-write locks
-    cout << "| Read-Write Locks            |";
+    string rule = "|-----------------------------|";
     for (int i = 0; i < num_thread_counts; i++) {
-        double time = RunTest(1, thread_counts[i], ops_per_thread);
-        cout << fixed << setprecision(3) << setw(7) << time << " |";
+        rule += "---------|";
     }
-    cout << endl;
-    
-    // ejecutar pruebas para un mutex para toda la lista
-    cout << "| One Mutex for Entire List   |";
+    cout << string(rule.size(), '=') << endl;
+    cout << "|                             | " << left << setw(10 * num_thread_counts - 3) << "Number of Threads"
+         << right << " |" << endl;
+    cout << rule << endl;
+    cout << "|        Implementation       |";
     for (int i = 0; i < num_thread_counts; i++) {
-        double time = RunTest(2, thread_counts[i], ops_per_thread);
-        cout << fixed << setprecision(3) << setw(7) << time << " |";
+        cout << setw(7) << thread_counts[i] << "  |";
     }
     cout << endl;
-    
-    // ejecutar pruebas para un mutex por nodo
-    cout << "| One Mutex per Node          |";
-    for (int i = 0; i < num_thread_counts; i++) {
-        double time = RunTest(3, thread_counts[i], ops_per_thread);
-        cout << fixed << setprecision(3) << setw(7) << time << " |";
+    cout << rule << endl;
+    
+    for (const list_impl& impl : impls) {
+        cout << "| " << left << setw(28) << impl.label << right << "|";
+        for (int i = 0; i < num_thread_counts; i++) {
+            bench_stats st = BenchmarkTest(&cfg, impl.record, impl.type, thread_counts[i], ops_per_thread);
+            records.push_back(st);
+            cout << fixed << setprecision(3) << setw(7) << st.mediana << "  |" << flush;
+        }
+        cout << endl;
     }
-    cout << endl;
     
-    cout << "=====================================================================" << endl;
-    cout << "\ntiempos en segundos" << endl;
+    cout << string(rule.size(), '=') << endl;
+    cout << "\ntiempos en segundos (mediana de " << cfg.repeticiones << " repeticiones)" << endl;
     cout << ops_per_thread << " ops/thread" << endl;
     cout << "99.9% member" << endl;
     cout << "0.05% insert" << endl;
     cout << "0.05% delete" << endl;
+    cout << "sin locks: CAS sobre next con marca de borrado, member sin escrituras; los nodos" << endl;
+    cout << "borrados se liberan por epocas cuando ningun thread puede estar leyendolos" << endl;
+    cout << "perezosa: recorre sin locks, bloquea solo pred y curr al cambiar y valida; member sin locks" << endl;
+    
+    for (size_t r = 0; r < records.size(); r++) {
+        bench_registrar(&cfg, &records[r]);
+    }
+    bench_config_cerrar(&cfg);
+    delete pool;
+    Clear_LockFree_List();
+    delete reclaimer_lf;
+    Clear_Lazy_List();
+    delete reclaimer_lazy;
     
     // limpiar recursos
     pthread_rwlock_destroy(&list_rwlock);
@@ -0,0 +1,532 @@
+#include <iostream>
+#include <pthread.h>
+#include <random>
+#include <vector>
+#include <deque>
+#include <cstdlib>
+#include <iomanip>
+#include <string>
+#include <cmath>
+
+#include "../comun/benchmark.h"
+#include "../comun/roofline.h"
+#include "affinity.h"
+
+using namespace std;
+
+//   Clase para gestionar las matrices del producto C = A * B
+class MatrixProductData {
+private:
+    vector<double> matA;
+    vector<double> matB;
+    vector<double> matC;
+    int n;
+
+public:
+    MatrixProductData(int size) : matA((size_t)size * size), matB((size_t)size * size),
+                                  matC((size_t)size * size), n(size) {
+        fillWithRandomData();
+    }
+
+    void fillWithRandomData() {
+        random_device rd;
+        mt19937 gen(rd());
+        uniform_real_distribution<double> dist(-1.0, 1.0);
+
+        for (size_t i = 0; i < matA.size(); i++) {
+            matA[i] = dist(gen);
+            matB[i] = dist(gen);
+        }
+        resetOutput();
+    }
+
+    void resetOutput() {
+        for (size_t i = 0; i < matC.size(); i++) {
+            matC[i] = 0.0;
+        }
+    }
+
+    double* getA() { return matA.data(); }
+    double* getB() { return matB.data(); }
+    double* getC() { return matC.data(); }
+    int getSize() { return n; }
+};
+
+//   Tile (ii, jj) de C, igual que en multiplicacion_bloques() de lab01
+struct Tile {
+    int ii;
+    int jj;
+};
+
+// Calcula el tile completo C[ii:ii+block][jj:jj+block] recorriendo todo kk
+static void computeTile(MatrixProductData* data, int block, Tile t) {
+    double* A = data->getA();
+    double* B = data->getB();
+    double* C = data->getC();
+    int n = data->getSize();
+
+    int iEnd = min(t.ii + block, n);
+    int jEnd = min(t.jj + block, n);
+
+    for (int kk = 0; kk < n; kk += block) {
+        int kEnd = min(kk + block, n);
+        for (int i = t.ii; i < iEnd; i++) {
+            for (int k = kk; k < kEnd; k++) {
+                double a = A[(size_t)i * n + k];
+                const double* filaB = B + (size_t)k * n;
+                double* filaC = C + (size_t)i * n;
+                for (int j = t.jj; j < jEnd; j++) {
+                    filaC[j] += a * filaB[j];
+                }
+            }
+        }
+    }
+}
+
+//   Deque por worker: el dueño saca por atras, los ladrones por delante
+class WorkStealingDeque {
+private:
+    deque<Tile> tiles;
+    pthread_mutex_t lock;
+
+public:
+    WorkStealingDeque() {
+        pthread_mutex_init(&lock, nullptr);
+    }
+
+    ~WorkStealingDeque() {
+        pthread_mutex_destroy(&lock);
+    }
+
+    void push(Tile t) {
+        pthread_mutex_lock(&lock);
+        tiles.push_back(t);
+        pthread_mutex_unlock(&lock);
+    }
+
+    bool popOwn(Tile& t) {
+        pthread_mutex_lock(&lock);
+        bool found = !tiles.empty();
+        if (found) {
+            t = tiles.back();
+            tiles.pop_back();
+        }
+        pthread_mutex_unlock(&lock);
+        return found;
+    }
+
+    bool steal(Tile& t) {
+        pthread_mutex_lock(&lock);
+        bool found = !tiles.empty();
+        if (found) {
+            t = tiles.front();
+            tiles.pop_front();
+        }
+        pthread_mutex_unlock(&lock);
+        return found;
+    }
+};
+
+//   Pool persistente de workers con robo de trabajo
+class WorkStealingPool {
+private:
+    struct WorkerSlot {
+        WorkStealingDeque queue;
+        long tilesDone;
+        long tilesStolen;
+    };
+
+    struct WorkerArg {
+        WorkStealingPool* pool;
+        int id;
+    };
+
+    int numWorkers;
+    vector<pthread_t> threads;
+    vector<WorkerArg> args;
+    WorkerSlot* slots;
+
+    pthread_mutex_t stateLock;
+    pthread_cond_t workReady;
+    pthread_cond_t workDone;
+    long generation;
+    int pending;
+    bool shuttingDown;
+
+    MatrixProductData* currentData;
+    int currentBlock;
+
+    static void* workerEntry(void* arg) {
+        WorkerArg* wa = (WorkerArg*)arg;
+        wa->pool->workerLoop(wa->id);
+        return nullptr;
+    }
+
+    bool nextTile(int id, mt19937& gen, Tile& t) {
+        if (slots[id].queue.popOwn(t)) {
+            return true;
+        }
+
+        // la cola propia esta vacia: intentar robar empezando por una victima aleatoria
+        int start = uniform_int_distribution<int>(0, numWorkers - 1)(gen);
+        for (int v = 0; v < numWorkers; v++) {
+            int victim = (start + v) % numWorkers;
+            if (victim != id && slots[victim].queue.steal(t)) {
+                slots[id].tilesStolen++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(int id) {
+        mt19937 gen(id * 7919 + 1);
+        long seenGeneration = 0;
+
+        while (true) {
+            pthread_mutex_lock(&stateLock);
+            while (generation == seenGeneration && !shuttingDown) {
+                pthread_cond_wait(&workReady, &stateLock);
+            }
+            if (shuttingDown) {
+                pthread_mutex_unlock(&stateLock);
+                return;
+            }
+            seenGeneration = generation;
+            pthread_mutex_unlock(&stateLock);
+
+            // los tiles solo se crean antes de despertar a los workers, asi que
+            // cuando no queda nada en ninguna cola este worker ha terminado
+            Tile t;
+            while (nextTile(id, gen, t)) {
+                computeTile(currentData, currentBlock, t);
+                slots[id].tilesDone++;
+            }
+
+            pthread_mutex_lock(&stateLock);
+            if (--pending == 0) {
+                pthread_cond_signal(&workDone);
+            }
+            pthread_mutex_unlock(&stateLock);
+        }
+    }
+
+public:
+    WorkStealingPool(int workers) : numWorkers(workers), threads(workers), args(workers),
+                                    generation(0), pending(0), shuttingDown(false),
+                                    currentData(nullptr), currentBlock(0) {
+        slots = new WorkerSlot[numWorkers];
+        pthread_mutex_init(&stateLock, nullptr);
+        pthread_cond_init(&workReady, nullptr);
+        pthread_cond_init(&workDone, nullptr);
+
+        for (int i = 0; i < numWorkers; i++) {
+            args[i].pool = this;
+            args[i].id = i;
+            pthread_create(&threads[i], nullptr, workerEntry, &args[i]);
+        }
+    }
+
+    int size() const { return numWorkers; }
+
+    bool pinWorker(int worker, int cpu) {
+        return Affinity::pinThread(threads[worker], cpu);
+    }
+
+    ~WorkStealingPool() {
+        pthread_mutex_lock(&stateLock);
+        shuttingDown = true;
+        pthread_cond_broadcast(&workReady);
+        pthread_mutex_unlock(&stateLock);
+
+        for (int i = 0; i < numWorkers; i++) {
+            pthread_join(threads[i], nullptr);
+        }
+
+        pthread_cond_destroy(&workReady);
+        pthread_cond_destroy(&workDone);
+        pthread_mutex_destroy(&stateLock);
+        delete[] slots;
+    }
+
+    // Reparte el espacio de tiles (ii, jj) en bloques contiguos por worker y
+    // espera a que todas las colas se vacien
+    void multiply(MatrixProductData* data, int block) {
+        int n = data->getSize();
+        int tilesPerDim = (n + block - 1) / block;
+        int totalTiles = tilesPerDim * tilesPerDim;
+
+        for (int w = 0; w < numWorkers; w++) {
+            slots[w].tilesDone = 0;
+            slots[w].tilesStolen = 0;
+        }
+
+        for (int t = 0; t < totalTiles; t++) {
+            int owner = (int)((long)t * numWorkers / totalTiles);
+            Tile tile = {(t / tilesPerDim) * block, (t % tilesPerDim) * block};
+            slots[owner].queue.push(tile);
+        }
+
+        pthread_mutex_lock(&stateLock);
+        currentData = data;
+        currentBlock = block;
+        pending = numWorkers;
+        generation++;
+        pthread_cond_broadcast(&workReady);
+        while (pending > 0) {
+            pthread_cond_wait(&workDone, &stateLock);
+        }
+        pthread_mutex_unlock(&stateLock);
+    }
+
+    long getStolenTiles() {
+        long total = 0;
+        for (int w = 0; w < numWorkers; w++) {
+            total += slots[w].tilesStolen;
+        }
+        return total;
+    }
+};
+
+//   Gestor de experimentos
+class BenchmarkManager {
+private:
+    const bench_config* config;
+
+    struct SampleContext {
+        BenchmarkManager* bench;
+        MatrixProductData* data;
+        int block;
+        WorkStealingPool* pool;
+    };
+
+    static double serialSample(void* arg) {
+        SampleContext* ctx = (SampleContext*)arg;
+        return ctx->bench->measureSerialTime(ctx->data, ctx->block);
+    }
+
+    static double parallelSample(void* arg) {
+        SampleContext* ctx = (SampleContext*)arg;
+        return ctx->bench->measureParallelTime(ctx->data, ctx->block, ctx->pool);
+    }
+
+public:
+    BenchmarkManager(const bench_config* cfg) : config(cfg) {}
+
+    double measureSerialTime(MatrixProductData* data, int block) {
+        int n = data->getSize();
+        data->resetOutput();
+
+        double t1 = bench_ahora();
+        for (int ii = 0; ii < n; ii += block) {
+            for (int jj = 0; jj < n; jj += block) {
+                Tile t = {ii, jj};
+                computeTile(data, block, t);
+            }
+        }
+        double t2 = bench_ahora();
+
+        return t2 - t1;
+    }
+
+    // el pool se crea fuera de la region medida: solo se mide el reparto y el calculo
+    double measureParallelTime(MatrixProductData* data, int block, WorkStealingPool* pool) {
+        data->resetOutput();
+
+        double t1 = bench_ahora();
+        pool->multiply(data, block);
+        double t2 = bench_ahora();
+
+        return t2 - t1;
+    }
+
+    // Calentamiento + repeticiones segun BENCH_WARMUP / BENCH_REPS
+    bench_stats benchmarkSerial(const string& name, MatrixProductData* data, int block) {
+        SampleContext ctx = {this, data, block, nullptr};
+        return bench_repetir(name.c_str(), config, serialSample, &ctx);
+    }
+
+    bench_stats benchmarkParallel(const string& name, MatrixProductData* data, int block,
+                                  WorkStealingPool* pool) {
+        SampleContext ctx = {this, data, block, pool};
+        return bench_repetir(name.c_str(), config, parallelSample, &ctx);
+    }
+
+    double computeSpeedup(double serialT, double parallelT) {
+        return serialT / parallelT;
+    }
+
+    double computeEfficiency(double serialT, double parallelT, int threads) {
+        return serialT / (parallelT * threads);
+    }
+
+    // Roofline: 2n^3 FLOP; trafico compulsorio A y B leidas, C leida y escrita
+    static double flopCount(int n) {
+        return 2.0 * n * n * (double)n;
+    }
+
+    static double byteCount(int n) {
+        return 8.0 * 4.0 * n * (double)n;
+    }
+};
+
+//   Clase para presentar resultados
+class ResultPresenter {
+private:
+    int sizes[3] = {500, 1000, 1500};
+    int threadOptions[4] = {1, 2, 4, 8};
+    int block = 64;
+    const bench_config* config;
+
+    string recordName(const char* kind, int n, int threads) {
+        return string("matmat/") + kind + "/n=" + to_string(n) + "/b=" + to_string(block) +
+               "/t=" + to_string(threads);
+    }
+
+public:
+    ResultPresenter(const bench_config* cfg) : config(cfg) {}
+
+    void displayHeader() {
+        cout << "\n=== analisis de rendimiento - matriz-matriz multiplication ===" << endl;
+        cout << "implementacion: tiles (ii, jj) con colas por worker y robo de trabajo" << endl;
+        cout << "tamaño de bloque: " << block << endl;
+        cout << "afinidad (LAB04_AFINIDAD): " << Affinity::policyName() << endl;
+        cout << "\n";
+
+        cout << "    ======" << endl;
+        cout << "|         |                               Matrix Dimension                              |" << endl;
+        cout << "|---------|-------------------------|-------------------------|-------------------------|" << endl;
+        cout << "| Threads |        500 x 500        |       1000 x 1000       |       1500 x 1500       |" << endl;
+        cout << "|---------|-------------------------|-------------------------|-------------------------|" << endl;
+        cout << "|         | Time    Speedup Eff.    | Time    Speedup Eff.    | Time    Speedup Eff.    |" << endl;
+        cout << "|---------|-------------------------|-------------------------|-------------------------|" << endl;
+    }
+
+    void runExperiments() {
+        double times[3][4];
+        long stolen[3][4];
+        double maxDiff[3][4];
+        double baselineTimes[3];
+        BenchmarkManager bench(config);
+        vector<bench_stats> records;
+
+        for (int s = 0; s < 3; s++) {
+            cout << "procesando dimension " << sizes[s] << " x " << sizes[s] << "..." << endl;
+
+            MatrixProductData* data = new MatrixProductData(sizes[s]);
+            bench_stats serial = bench.benchmarkSerial(recordName("serial", sizes[s], 1), data, block);
+            records.push_back(serial);
+            baselineTimes[s] = serial.mediana;
+            // C del serial como referencia: un tile perdido o sumado dos
+            // veces por el robo se ve como diferencia
+            size_t elements = (size_t)sizes[s] * sizes[s];
+            vector<double> reference(data->getC(), data->getC() + elements);
+
+            for (int t = 0; t < 4; t++) {
+                WorkStealingPool pool(threadOptions[t]);
+                Affinity::pinPool(pool);
+                bench_stats par = bench.benchmarkParallel(
+                    recordName("robo", sizes[s], threadOptions[t]), data, block, &pool);
+                records.push_back(par);
+                times[s][t] = par.mediana;
+                stolen[s][t] = pool.getStolenTiles();
+
+                const double* C = data->getC();
+                maxDiff[s][t] = 0.0;
+                for (size_t i = 0; i < elements; i++) {
+                    maxDiff[s][t] = max(maxDiff[s][t], fabs(C[i] - reference[i]) / max(1.0, fabs(reference[i])));
+                }
+            }
+
+            delete data;
+        }
+
+        displayResults(times, stolen, maxDiff, baselineTimes);
+        displayRoofline(times);
+
+        for (size_t r = 0; r < records.size(); r++) {
+            bench_registrar(config, &records[r]);
+        }
+    }
+
+    void displayResults(double times[3][4], long stolen[3][4], double maxDiff[3][4], double baseline[3]) {
+        BenchmarkManager bench(config);
+
+        for (int t = 0; t < 4; t++) {
+            cout << "| " << setw(7) << threadOptions[t] << " |";
+            for (int s = 0; s < 3; s++) {
+                double speedup = bench.computeSpeedup(baseline[s], times[s][t]);
+                double eff = bench.computeEfficiency(baseline[s], times[s][t], threadOptions[t]);
+                cout << fixed << setprecision(3) << setw(7) << times[s][t] << " "
+                     << setw(7) << speedup << " " << setw(7) << eff << "  |";
+            }
+            cout << endl;
+        }
+        cout << "    ======" << endl;
+
+        cout << "\ntiles robados (ultima repeticion):" << endl;
+        for (int t = 0; t < 4; t++) {
+            cout << "  " << threadOptions[t] << " threads:";
+            for (int s = 0; s < 3; s++) {
+                cout << " " << setw(6) << stolen[s][t];
+            }
+            cout << endl;
+        }
+
+        cout << "\nmax |dif| contra el serial (ultima repeticion):" << endl;
+        for (int t = 0; t < 4; t++) {
+            cout << "  " << threadOptions[t] << " threads:";
+            for (int s = 0; s < 3; s++) {
+                cout << " " << scientific << setprecision(2) << maxDiff[s][t] << fixed;
+            }
+            cout << endl;
+        }
+    }
+
+    // Caracteriza la maquina con cada numero de threads y ubica cada medicion
+    void displayRoofline(double times[3][4]) {
+        for (int t = 0; t < 4; t++) {
+            roofline_maquina machine = roofline_caracterizar(threadOptions[t]);
+            if (!machine.activo) return;
+
+            cout << "\n" << flush;
+            roofline_imprimir_maquina(&machine);
+            roofline_cabecera();
+            for (int s = 0; s < 3; s++) {
+                roofline_reportar(&machine, recordName("robo", sizes[s], threadOptions[t]).c_str(),
+                                  BenchmarkManager::flopCount(sizes[s]),
+                                  BenchmarkManager::byteCount(sizes[s]), times[s][t]);
+            }
+            fflush(stdout);
+        }
+    }
+
+    void displayFooter() {
+        cout << "\ntiempos en segundos (mediana de " << config->repeticiones << " repeticiones, "
+             << config->calentamiento << " de calentamiento)" << endl;
+        cout << "speedup = tiempo_serial / tiempo_paralelo" << endl;
+        cout << "eficiencia = tiempo_serial / (tiempo_paralelo * num_threads)" << endl;
+
+        cout << "\n=== analisis de rendimiento ===" << endl;
+        cout << "- cada worker recibe un bloque contiguo de tiles en su propia cola" << endl;
+        cout << "- un worker sin trabajo roba tiles del frente de la cola de otro" << endl;
+        cout << "- los tiles del borde (n no multiplo del bloque) son mas pequeños" << endl;
+        cout << "- el pool se crea una vez por numero de threads, fuera de la medicion" << endl;
+    }
+};
+
+//   Función principal
+int main(int argc, char**) {
+    if (argc != 1) {
+        return 1;
+    }
+
+    bench_config cfg = bench_config_entorno();
+    ResultPresenter presenter(&cfg);
+    presenter.displayHeader();
+    presenter.runExperiments();
+    presenter.displayFooter();
+    bench_config_cerrar(&cfg);
+
+    return 0;
+}
@@ -1,73 +1,237 @@
 #include <iostream>
 #include <pthread.h>
-#include <chrono>
-#include <random>
 #include <vector>
 #include <cstdlib>
 #include <iomanip>
 #include <string>
+#include <cstring>
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+#include "../comun/benchmark.h"
+#include "../comun/roofline.h"
+#include "sparse_matrix.h"
+#include "reduced_matrix.h"
+#include "counter_rng.h"
+#include "thread_pool.h"
 
 using namespace std;
-using namespace std::chrono;
+
+//   Vista de una matriz row-major con paso explicito entre filas  
+struct MatrixView {
+    const double* data;
+    size_t stride;      // doubles entre el inicio de dos filas
+    int rows;
+    int cols;
+    
+    const double* row(int r) const { return data + (size_t)r * stride; }
+};
+
+//   Datos reproducibles: cada arreglo es una secuencia de CounterRng con la
+//   misma semilla (LAB04_SEMILLA), el elemento (i, j) de la matriz es el
+//   numero i * cols + j de su secuencia.
+enum DataStream {
+    STREAM_MATRIX = 0,
+    STREAM_INPUT = 1,
+    STREAM_SPARSE = 2,
+    STREAM_MULTI_X = 3
+};
+
+static uint64_t dataSeed = 1;
 
 //   Clase para gestionar datos de la matriz  
+//   Una sola reserva alineada a 64 bytes con las filas a paso 'stride'
+//   (cols redondeado a 8 doubles, una linea de cache): cada fila empieza
+//   alineada y no hay un puntero por fila que seguir.
 class MatrixData {
 private:
-    double** matrix;
+    static const size_t ALIGNMENT = 64;
+    
+    double* matrix;
+    size_t stride;
     double* inputVec;
     double* outputVec;
     int numRows;
     int numCols;
+    CsrMatrix* csr;
+    SellMatrix* sell;
+    ReducedMatrix* reduced;     // copia en menos bits (setStorage), o nullptr
     
 public:
-    MatrixData(int r, int c) : numRows(r), numCols(c) {
+    // Con 'pool' el llenado se reparte por bloques de filas entre sus workers
+    MatrixData(int r, int c, ThreadPool* pool = nullptr)
+        : matrix(nullptr), stride(0), numRows(r), numCols(c), csr(nullptr), sell(nullptr), reduced(nullptr) {
         allocateMemory();
-        fillWithRandomData();
+        fillWithRandomData(pool);
+    }
+    
+    // Matriz leida de un archivo: la copia densa solo si se pide (puede no
+    // entrar en memoria); x aleatorio como en el constructor normal
+    MatrixData(CsrMatrix* loaded, bool withDense, int sigma)
+        : matrix(nullptr), stride(0), numRows(loaded->rows), numCols(loaded->cols), csr(loaded), sell(nullptr),
+          reduced(nullptr) {
+        if (withDense) {
+            allocateMemory();
+            for (int i = 0; i < numRows; i++) {
+                double* row = getRow(i);
+                memset(row, 0, numCols * sizeof(double));
+                for (long p = csr->rowPtr[i]; p < csr->rowPtr[i + 1]; p++) {
+                    row[csr->colIdx[p]] = csr->values[p];
+                }
+            }
+        } else {
+            inputVec = new double[numCols];
+            outputVec = allocateOutput(numRows);
+        }
+        CounterRng(dataSeed, STREAM_INPUT).fillUniform(inputVec, 0, numCols, -1.0, 1.0);
+        resetOutput();
+        sell = new SellMatrix();
+        sell->fromCsr(*csr, sigma);
     }
     
     ~MatrixData() {
         releaseMemory();
+        delete csr;
+        delete sell;
+        delete reduced;
     }
     
-    void allocateMemory() {
-        random_device rd;
-        mt19937 generator(rd());
-        uniform_real_distribution<double> distribution(-1.0, 1.0);
-        
-        matrix = new double*[numRows];
-        for (int i = 0; i < numRows; i++) {
-            matrix[i] = new double[numCols];
+    static size_t strideFor(int cols) {
+        size_t perLine = ALIGNMENT / sizeof(double);
+        return ((size_t)cols + perLine - 1) / perLine * perLine;
+    }
+    
+    // y alineado a 64 bytes: las filas 8k..8k+7 comparten una sola linea de cache
+    static double* allocateOutput(int rows) {
+        size_t bytes = ((size_t)rows * sizeof(double) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        double* out = (double*) aligned_alloc(ALIGNMENT, bytes);
+        if (out == nullptr) {
+            cerr << "no se pudo reservar y (" << rows << " filas)" << endl;
+            exit(1);
+        }
+        return out;
+    }
+    
+    // Sin tocar: las paginas quedan en el nodo del primer thread que escribe
+    // (las reservas grandes las pide malloc con mmap, siempre nuevas)
+    static double* allocateSlab(int rows, size_t rowStride) {
+        size_t bytes = (size_t)rows * rowStride * sizeof(double);
+        double* slab = (double*) aligned_alloc(ALIGNMENT, (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT);
+        if (slab == nullptr) {
+            cerr << "no se pudo reservar la matriz " << rows << " x " << rowStride << endl;
+            exit(1);
         }
+        return slab;
+    }
+    
+    void allocateMemory() {
+        stride = strideFor(numCols);
+        matrix = allocateSlab(numRows, stride);
         
         inputVec = new double[numCols];
-        outputVec = new double[numRows];
+        outputVec = allocateOutput(numRows);
+    }
+    
+    // Reemplaza la densa e y por copias ya ubicadas (BenchmarkManager::placePages)
+    void adoptStorage(double* newMatrix, double* newOutput) {
+        free(matrix);
+        free(outputVec);
+        matrix = newMatrix;
+        outputVec = newOutput;
+    }
+    
+private:
+    // Parte de un llenado paralelo: filas [rowBegin, rowEnd) de la matriz y
+    // [colBegin, colEnd) de x
+    struct FillTask {
+        MatrixData* data;
+        int rowBegin, rowEnd;
+        int colBegin, colEnd;
+    };
+    
+    static void* fillEntry(void* arg) {
+        FillTask* task = (FillTask*)arg;
+        task->data->fillRange(task->rowBegin, task->rowEnd, task->colBegin, task->colEnd);
+        return nullptr;
+    }
+    
+    void fillRange(int rowBegin, int rowEnd, int colBegin, int colEnd) {
+        CounterRng matrixRng(dataSeed, STREAM_MATRIX);
+        for (int i = rowBegin; i < rowEnd; i++) {
+            matrixRng.fillUniform(getRow(i), (uint64_t)i * numCols, numCols, -1.0, 1.0);
+        }
+        CounterRng(dataSeed, STREAM_INPUT).fillUniform(inputVec + colBegin, colBegin, colEnd - colBegin, -1.0, 1.0);
+        for (int i = rowBegin; i < rowEnd; i++) {
+            outputVec[i] = 0.0;
+        }
+    }
+    
+public:
+    // Mismos valores con cualquier cantidad de workers; cada worker escribe
+    // primero sus filas, asi sus paginas quedan en su nodo (primer toque)
+    void fillWithRandomData(ThreadPool* pool = nullptr) {
+        int workers = (pool != nullptr) ? min(pool->size(), numRows) : 1;
+        if (workers <= 1) {
+            fillRange(0, numRows, 0, numCols);
+            return;
+        }
+        vector<FillTask> tasks(workers);
+        vector<void*> args(workers);
+        for (int w = 0; w < workers; w++) {
+            tasks[w] = {this, (int)((long)numRows * w / workers), (int)((long)numRows * (w + 1) / workers),
+                        (int)((long)numCols * w / workers), (int)((long)numCols * (w + 1) / workers)};
+            args[w] = &tasks[w];
+        }
+        pool->runParallel(workers, fillEntry, args.data());
     }
     
-    void fillWithRandomData() {
-        random_device rd;
-        mt19937 gen(rd());
-        uniform_real_distribution<double> dist(-1.0, 1.0);
+    // Deja una fraccion ~density de no ceros y arma CSR y SELL con ellos. La
+    // probabilidad baja linealmente con la fila (2*density arriba, 0 abajo)
+    // para que repartir filas iguales deje threads con mas trabajo que otros.
+    void makeSparse(double density, int sigma) {
+        CounterRng coin(dataSeed, STREAM_SPARSE);
+        vector<double> draws(numCols);
         
         for (int i = 0; i < numRows; i++) {
+            double keep = 2.0 * density * (numRows - i) / numRows;
+            double* row = getRow(i);
+            coin.fillUniform(draws.data(), (uint64_t)i * numCols, numCols, 0.0, 1.0);
             for (int j = 0; j < numCols; j++) {
-                matrix[i][j] = dist(gen);
+                if (draws[j] >= keep) {
+                    row[j] = 0.0;
+                }
             }
         }
         
-        for (int j = 0; j < numCols; j++) {
-            inputVec[j] = dist(gen);
+        delete csr;
+        delete sell;
+        csr = new CsrMatrix();
+        csr->fromDense(matrix, stride, numRows, numCols);
+        sell = new SellMatrix();
+        sell->fromCsr(*csr, sigma);
+    }
+    
+    // Formato en que leen la matriz las estrategias de precision reducida; la
+    // densa en double se conserva como referencia
+    void setStorage(StorageFormat format) {
+        delete reduced;
+        reduced = nullptr;
+        if (format == STORAGE_F64 || matrix == nullptr) return;
+        reduced = new ReducedMatrix();
+        if (!reduced->fromDense(format, matrix, stride, numRows, numCols)) {
+            cerr << "no se pudo reservar la copia " << storageName(format) << endl;
+            exit(1);
         }
-        
-        resetOutput();
     }
     
+    StorageFormat getStorage() { return reduced != nullptr ? reduced->format : STORAGE_F64; }
+    ReducedMatrix* getReduced() { return reduced; }
+    
     void releaseMemory() {
-        for (int i = 0; i < numRows; i++) {
-            delete[] matrix[i];
-        }
-        delete[] matrix;
+        free(matrix);
         delete[] inputVec;
-        delete[] outputVec;
+        free(outputVec);
     }
     
     void resetOutput() {
@@ -76,7 +240,12 @@ public:
         }
     }
     
-    double** getMatrix() { return matrix; }
+    bool hasDense() { return matrix != nullptr; }
+    double* getRow(int r) { return matrix + (size_t)r * stride; }
+    size_t getStride() { return stride; }
+    MatrixView getView() { return MatrixView{matrix, stride, numRows, numCols}; }
+    CsrMatrix* getCsr() { return csr; }
+    SellMatrix* getSell() { return sell; }
     double* getInput() { return inputVec; }
     double* getOutput() { return outputVec; }
     int getRows() { return numRows; }
@@ -87,151 +256,666 @@ public:
 struct ThreadConfig {
     int id;
     MatrixData* data;
+    MatrixView view;    // vista densa de data (vacia si no hay copia densa)
     int totalThreads;
 };
 
 //   Estrategias de multiplicación  
+//   La suma de cada fila se acumula en un registro y y se escribe una vez por
+//   fila; los rangos contiguos se escriben de a una linea de cache entera
+//   (ROWS_PER_LINE filas), asi dos threads no se disputan la misma linea de y.
+
+static const int ROWS_PER_LINE = 8;   // doubles de y en una linea de 64 bytes
+
+static inline double rowDot(const MatrixView& mat, int r, const double* in) {
+    const double* row = mat.row(r);
+    double sum = 0.0;
+    for (int c = 0; c < mat.cols; c++) {
+        sum += row[c] * in[c];
+    }
+    return sum;
+}
+
+// out[begin, end) con una escritura por linea de cache (begin multiplo de
+// ROWS_PER_LINE para que las lineas no se compartan)
+static void denseRowRange(const MatrixView& mat, const double* in, double* out, int begin, int end) {
+    double line[ROWS_PER_LINE];
+    for (int r0 = begin; r0 < end; r0 += ROWS_PER_LINE) {
+        int n = min(ROWS_PER_LINE, end - r0);
+        if (n == ROWS_PER_LINE) {
+            for (int i = 0; i < ROWS_PER_LINE; i++) {
+                line[i] = rowDot(mat, r0 + i, in);
+            }
+            memcpy(out + r0, line, sizeof(line));
+            continue;
+        }
+        for (int i = 0; i < n; i++) {
+            out[r0 + i] = rowDot(mat, r0 + i, in);
+        }
+    }
+}
+
+// Filas por reparto redondeadas a lineas de cache, salvo que haya tan pocas
+// filas que redondear dejaria threads sin trabajo (8 x 8,000,000)
+static inline int lineAlignedRows(int rows, int threads, int wanted) {
+    if ((long)rows < (long)threads * ROWS_PER_LINE) return max(1, wanted);
+    return (wanted + ROWS_PER_LINE - 1) / ROWS_PER_LINE * ROWS_PER_LINE;
+}
+
+// Recibe cada rectangulo [r0, r1) x [c0, c1) de la matriz densa
+typedef void (*TileVisitor)(void* ctx, int r0, int r1, int c0, int c1);
+
+static void countTile(void* ctx, int r0, int r1, int c0, int c1) {
+    *(long*)ctx += (long)(r1 - r0) * (c1 - c0);
+}
+
 class MultiplicationStrategy {
 public:
     virtual void executeSerial(MatrixData* data) = 0;
     virtual void* executeParallel(void* config) = 0;
+    // Antes de cada corrida paralela, fuera de la medicion
+    virtual void prepareParallel(MatrixData* data, int threads) { (void)data; (void)threads; }
+    // Partes de la densa que lee el thread 'id' en executeParallel (despues de
+    // prepareParallel), para ubicar sus paginas por primer toque. false si la
+    // estrategia no lee la densa o si las filas no tienen un thread fijo.
+    virtual bool visitTiles(int id, int threads, const MatrixView& mat, TileVisitor visit, void* ctx) {
+        (void)id; (void)threads; (void)mat; (void)visit; (void)ctx;
+        return false;
+    }
+    // Elementos de la densa que multiplico el thread 'id' en la ultima corrida
+    // (por defecto los de visitTiles); -1 si no se sabe
+    virtual long elementsDone(int id, int threads, const MatrixView& mat) {
+        long count = 0;
+        if (!visitTiles(id, threads, mat, countTile, &count)) return -1;
+        return count;
+    }
     virtual ~MultiplicationStrategy() {}
 };
 
 class BlockStrategy : public MultiplicationStrategy {
 public:
+    static void rowRange(int id, int threads, int rows, int& begin, int& end) {
+        int chunkSize = lineAlignedRows(rows, threads, rows / threads);
+        begin = min(rows, id * chunkSize);
+        end = (id == threads - 1) ? rows : min(rows, (id + 1) * chunkSize);
+    }
+    
     void executeSerial(MatrixData* data) override {
-        double** mat = data->getMatrix();
-        double* in = data->getInput();
-        double* out = data->getOutput();
-        int rows = data->getRows();
-        int cols = data->getCols();
+        MatrixView mat = data->getView();
+        denseRowRange(mat, data->getInput(), data->getOutput(), 0, mat.rows);
+    }
+    
+    void* executeParallel(void* config) override {
+        ThreadConfig* cfg = (ThreadConfig*)config;
+        MatrixData* data = cfg->data;
         
-        for (int r = 0; r < rows; r++) {
-            out[r] = 0.0;
-            for (int c = 0; c < cols; c++) {
-                out[r] += mat[r][c] * in[c];
-            }
-        }
+        const MatrixView& mat = cfg->view;
+        int startRow, endRow;
+        rowRange(cfg->id, cfg->totalThreads, mat.rows, startRow, endRow);
+        
+        denseRowRange(mat, data->getInput(), data->getOutput(), startRow, endRow);
+        
+        return nullptr;
+    }
+    
+    bool visitTiles(int id, int threads, const MatrixView& mat, TileVisitor visit, void* ctx) override {
+        int begin, end;
+        rowRange(id, threads, mat.rows, begin, end);
+        visit(ctx, begin, end, 0, mat.cols);
+        return true;
+    }
+};
+
+class InterleavedStrategy : public MultiplicationStrategy {
+public:
+    void executeSerial(MatrixData* data) override {
+        MatrixView mat = data->getView();
+        denseRowRange(mat, data->getInput(), data->getOutput(), 0, mat.rows);
     }
     
     void* executeParallel(void* config) override {
         ThreadConfig* cfg = (ThreadConfig*)config;
         MatrixData* data = cfg->data;
         
-        double** mat = data->getMatrix();
+        const MatrixView& mat = cfg->view;
         double* in = data->getInput();
         double* out = data->getOutput();
-        int rows = data->getRows();
-        int cols = data->getCols();
         
-        int chunkSize = rows / cfg->totalThreads;
-        int startRow = cfg->id * chunkSize;
-        int endRow = (cfg->id == cfg->totalThreads - 1) ? rows : (cfg->id + 1) * chunkSize;
+        // filas alternadas: cada linea de y sigue siendo de varios threads,
+        // pero cada uno la escribe una vez por fila y no en cada columna
+        for (int r = cfg->id; r < mat.rows; r += cfg->totalThreads) {
+            out[r] = rowDot(mat, r, in);
+        }
         
-        for (int r = startRow; r < endRow; r++) {
-            out[r] = 0.0;
-            for (int c = 0; c < cols; c++) {
-                out[r] += mat[r][c] * in[c];
-            }
+        return nullptr;
+    }
+    
+    bool visitTiles(int id, int threads, const MatrixView& mat, TileVisitor visit, void* ctx) override {
+        for (int r = id; r < mat.rows; r += threads) {
+            visit(ctx, r, r + 1, 0, mat.cols);
+        }
+        return true;
+    }
+};
+
+// Bloque-ciclica: bloques de chunkLines lineas de cache de y (8 filas por
+// linea) repartidos en ronda. Balancea como la ciclica pero cada linea de y
+// la escribe un solo thread.
+class BlockCyclicStrategy : public MultiplicationStrategy {
+private:
+    int chunkLines;
+    
+public:
+    BlockCyclicStrategy(int lines) : chunkLines(lines) {}
+    
+    void setChunkLines(int lines) { chunkLines = max(1, lines); }
+    int getChunkLines() { return chunkLines; }
+    
+    void executeSerial(MatrixData* data) override {
+        MatrixView mat = data->getView();
+        denseRowRange(mat, data->getInput(), data->getOutput(), 0, mat.rows);
+    }
+    
+    // con pocas filas un bloque de lineas enteras dejaria threads sin trabajo
+    int chunkRows(int rows, int threads) {
+        int chunk = chunkLines * ROWS_PER_LINE;
+        if ((long)chunk * threads > rows) {
+            chunk = lineAlignedRows(rows, threads, rows / threads);
         }
+        return chunk;
+    }
+    
+    void* executeParallel(void* config) override {
+        ThreadConfig* cfg = (ThreadConfig*)config;
+        const MatrixView& mat = cfg->view;
+        int rows = mat.rows;
+        int chunk = chunkRows(rows, cfg->totalThreads);
         
+        for (int start = cfg->id * chunk; start < rows; start += cfg->totalThreads * chunk) {
+            denseRowRange(mat, cfg->data->getInput(), cfg->data->getOutput(), start, min(rows, start + chunk));
+        }
         return nullptr;
     }
+    
+    bool visitTiles(int id, int threads, const MatrixView& mat, TileVisitor visit, void* ctx) override {
+        int chunk = chunkRows(mat.rows, threads);
+        for (int start = id * chunk; start < mat.rows; start += threads * chunk) {
+            visit(ctx, start, min(mat.rows, start + chunk), 0, mat.cols);
+        }
+        return true;
+    }
 };
 
-class InterleavedStrategy : public MultiplicationStrategy {
+// Reparto dinamico: cada thread pide el proximo rango de filas a un contador
+// atomico compartido cuando termina el anterior, asi un thread demorado (una
+// interrupcion, un hermano SMT ocupado, mas threads que nucleos) solo atrasa
+// el rango que tiene en la mano y los demas se llevan el resto.
+// - fija: chunkLines lineas de y por pedido, como los bloques de la
+//   bloque-ciclica pero sin dueno de antemano.
+// - guiada: lo que falta / (2 * threads), redondeado a lineas enteras y de al
+//   menos una: pocos pedidos grandes al principio y chicos al cierre.
+// Cuenta por thread los elementos y pedidos de la ultima corrida.
+class DynamicStrategy : public MultiplicationStrategy {
+private:
+    struct alignas(64) WorkerCount {
+        long elements;
+        int chunks;
+    };
+    
+    bool guided;
+    int chunkLines;
+    alignas(64) atomic<int> nextRow;
+    vector<WorkerCount> counts;
+    
+    int fixedChunk(int rows, int threads) {
+        int chunk = chunkLines * ROWS_PER_LINE;
+        if ((long)chunk * threads > rows) {
+            chunk = lineAlignedRows(rows, threads, rows / threads);
+        }
+        return chunk;
+    }
+    
+    // [begin, end) del proximo pedido; false si ya no quedan filas
+    bool claim(int rows, int threads, int& begin, int& end) {
+        if (!guided) {
+            int chunk = fixedChunk(rows, threads);
+            begin = nextRow.fetch_add(chunk, memory_order_relaxed);
+            if (begin >= rows) return false;
+            end = min(rows, begin + chunk);
+            return true;
+        }
+        int current = nextRow.load(memory_order_relaxed);
+        while (current < rows) {
+            int remaining = rows - current;
+            int chunk = min(remaining, lineAlignedRows(rows, threads, max(1, remaining / (2 * threads))));
+            if (nextRow.compare_exchange_weak(current, current + chunk, memory_order_relaxed)) {
+                begin = current;
+                end = current + chunk;
+                return true;
+            }
+        }
+        return false;
+    }
+    
 public:
+    DynamicStrategy(bool guidedChunks, int lines) : guided(guidedChunks), chunkLines(lines), nextRow(0) {}
+    
+    void setChunkLines(int lines) { chunkLines = max(1, lines); }
+    
     void executeSerial(MatrixData* data) override {
-        double** mat = data->getMatrix();
+        MatrixView mat = data->getView();
+        denseRowRange(mat, data->getInput(), data->getOutput(), 0, mat.rows);
+    }
+    
+    void prepareParallel(MatrixData* data, int threads) override {
+        (void)data;
+        nextRow.store(0, memory_order_relaxed);
+        counts.assign(threads, WorkerCount{0, 0});
+    }
+    
+    void* executeParallel(void* config) override {
+        ThreadConfig* cfg = (ThreadConfig*)config;
+        const MatrixView& mat = cfg->view;
+        long elements = 0;
+        int chunks = 0;
+        int begin, end;
+        while (claim(mat.rows, cfg->totalThreads, begin, end)) {
+            denseRowRange(mat, cfg->data->getInput(), cfg->data->getOutput(), begin, end);
+            elements += (long)(end - begin) * mat.cols;
+            chunks++;
+        }
+        counts[cfg->id].elements = elements;
+        counts[cfg->id].chunks = chunks;
+        return nullptr;
+    }
+    
+    long elementsDone(int id, int threads, const MatrixView& mat) override {
+        (void)threads; (void)mat;
+        return id < (int)counts.size() ? counts[id].elements : -1;
+    }
+    
+    int chunksDone(int id) { return id < (int)counts.size() ? counts[id].chunks : 0; }
+};
+
+// Division por filas leyendo la copia reducida de MatrixData (setStorage),
+// con la suma en double. Sin copia reducida lee la densa con el mismo kernel
+// (reducedDot), asi la comparacion entre formatos mide bytes y conversion y
+// no la diferencia entre kernels.
+class ReducedStrategy : public MultiplicationStrategy {
+private:
+    static void multiplyRows(MatrixData* data, const MatrixView& mat, int begin, int end) {
+        ReducedMatrix* reduced = data->getReduced();
         double* in = data->getInput();
         double* out = data->getOutput();
+        if (reduced != nullptr) {
+            reduced->multiplyRows(begin, end, in, out);
+            return;
+        }
+        for (int r = begin; r < end; r++) {
+            out[r] = reducedDot(mat.row(r), in, mat.cols);
+        }
+    }
+    
+public:
+    void executeSerial(MatrixData* data) override {
+        multiplyRows(data, data->getView(), 0, data->getRows());
+    }
+    
+    void* executeParallel(void* config) override {
+        ThreadConfig* cfg = (ThreadConfig*)config;
+        int begin, end;
+        BlockStrategy::rowRange(cfg->id, cfg->totalThreads, cfg->data->getRows(), begin, end);
+        multiplyRows(cfg->data, cfg->view, begin, end);
+        return nullptr;
+    }
+};
+
+// Particion 2D: grilla de rowBlocks x colBlocks threads. Cada thread multiplica
+// su tile (franja de filas x franja de columnas) en un y parcial propio; los
+// parciales de una misma franja de filas se suman en arbol, log2(colBlocks)
+// pasos separados por barreras, y en cada paso los dos threads del par se
+// reparten las filas. El ultimo paso escribe directo en y.
+//
+// Con autoShape = false es la division por columnas pura (rowBlocks = 1): en
+// 8 x 8,000,000 cada thread lee solo su parte de x en vez de los 64 MB.
+// Con autoShape = true la grilla sale de la forma de la matriz (chooseGrid).
+class TiledStrategy : public MultiplicationStrategy {
+private:
+    bool autoShape;
+    int rowBlocks, colBlocks;
+    int rowChunk, colChunk;
+    size_t partialStride;        // doubles por parcial, multiplo de una linea
+    vector<double*> partials;    // uno por tile activo, vacio sin reduccion
+    SenseBarrier barrier;
+    
+    void releasePartials() {
+        for (double* p : partials) free(p);
+        partials.clear();
+    }
+    
+    static void tileRows(const MatrixView& mat, const double* in, double* dst,
+                         int r0, int r1, int c0, int c1) {
+        for (int r = r0; r < r1; r++) {
+            const double* row = mat.row(r);
+            double sum = 0.0;
+            for (int c = c0; c < c1; c++) {
+                sum += row[c] * in[c];
+            }
+            dst[r - r0] = sum;
+        }
+    }
+    
+public:
+    TiledStrategy(bool shape) : autoShape(shape), rowBlocks(1), colBlocks(1),
+                                rowChunk(0), colChunk(0), partialStride(0) {}
+    
+    ~TiledStrategy() { releasePartials(); }
+    
+    // Entre los divisores de 'threads' elige la grilla que minimiza los
+    // elementos de x e y que toca cada thread (rows/rb + cols/cb); a igualdad
+    // prefiere mas franjas de filas, que no necesitan reduccion
+    static void chooseGrid(int rows, int cols, int threads, int& rb, int& cb) {
+        rb = 1;
+        cb = threads;
+        double best = -1.0;
+        for (int d = 1; d <= threads; d++) {
+            if (threads % d != 0 || d > rows) continue;
+            double cost = (double)rows / d + (double)cols / (threads / d);
+            if (best < 0.0 || cost <= best) {
+                best = cost;
+                rb = d;
+                cb = threads / d;
+            }
+        }
+    }
+    
+    void executeSerial(MatrixData* data) override {
+        MatrixView mat = data->getView();
+        denseRowRange(mat, data->getInput(), data->getOutput(), 0, mat.rows);
+    }
+    
+    void prepareParallel(MatrixData* data, int threads) override {
         int rows = data->getRows();
         int cols = data->getCols();
+        if (autoShape) {
+            chooseGrid(rows, cols, threads, rowBlocks, colBlocks);
+        } else {
+            rowBlocks = 1;
+            colBlocks = min(threads, cols);
+        }
+        rowChunk = lineAlignedRows(rows, rowBlocks, rows / rowBlocks);
+        // franjas de columnas en lineas de cache enteras de x (la ultima se
+        // lleva el resto); redondear puede dejar menos franjas que las pedidas
+        // (8 columnas entre 4 threads es una sola) y los threads que sobran no
+        // reciben tile
+        colChunk = max(ROWS_PER_LINE, (cols / colBlocks + ROWS_PER_LINE - 1) / ROWS_PER_LINE * ROWS_PER_LINE);
+        colBlocks = min(colBlocks, (cols + colChunk - 1) / colChunk);
         
-        for (int r = 0; r < rows; r++) {
-            out[r] = 0.0;
-            for (int c = 0; c < cols; c++) {
-                out[r] += mat[r][c] * in[c];
+        // parciales solo si hay reduccion, y solo para los tiles activos
+        int tiles = (colBlocks > 1) ? rowBlocks * colBlocks : 0;
+        int longest = max(rowChunk, rows - (rowBlocks - 1) * rowChunk);
+        size_t stride = ((size_t)longest + ROWS_PER_LINE - 1) / ROWS_PER_LINE * ROWS_PER_LINE;
+        if (stride != partialStride || (int)partials.size() != tiles) {
+            releasePartials();
+            partialStride = stride;
+            for (int i = 0; i < tiles; i++) {
+                partials.push_back((double*) aligned_alloc(64, partialStride * sizeof(double)));
             }
         }
+        barrier.reset(threads);
+    }
+    
+    // Tile del thread 'id'; false (y tile vacio) para los threads de mas
+    // cuando la grilla tiene menos tiles que threads: como cb = id % colBlocks,
+    // los que sobran son los de rb >= rowBlocks
+    bool tileBounds(int id, const MatrixView& mat, int& r0, int& r1, int& c0, int& c1) {
+        int rb = id / colBlocks;
+        int cb = id % colBlocks;
+        r0 = min(mat.rows, rb * rowChunk);
+        r1 = (rb == rowBlocks - 1) ? mat.rows : min(mat.rows, (rb + 1) * rowChunk);
+        c0 = min(mat.cols, cb * colChunk);
+        c1 = (cb == colBlocks - 1) ? mat.cols : min(mat.cols, (cb + 1) * colChunk);
+        if (rb >= rowBlocks) {
+            r0 = r1 = 0;
+            return false;
+        }
+        return true;
     }
     
     void* executeParallel(void* config) override {
         ThreadConfig* cfg = (ThreadConfig*)config;
-        MatrixData* data = cfg->data;
+        const MatrixView& mat = cfg->view;
+        double* out = cfg->data->getOutput();
+        // los threads de mas solo pasan las barreras
+        int rb = cfg->id / colBlocks;
+        int cb = cfg->id % colBlocks;
+        int r0, r1, c0, c1;
+        bool active = tileBounds(cfg->id, mat, r0, r1, c0, c1);
         
-        double** mat = data->getMatrix();
-        double* in = data->getInput();
-        double* out = data->getOutput();
-        int rows = data->getRows();
-        int cols = data->getCols();
+        if (colBlocks == 1) {
+            tileRows(mat, cfg->data->getInput(), out + r0, r0, r1, c0, c1);
+            return nullptr;
+        }
+        if (active) {
+            tileRows(mat, cfg->data->getInput(), partials[cfg->id], r0, r1, c0, c1);
+        }
         
-        for (int r = cfg->id; r < rows; r += cfg->totalThreads) {
-            out[r] = 0.0;
-            for (int c = 0; c < cols; c++) {
-                out[r] += mat[r][c] * in[c];
+        int n = r1 - r0;
+        for (int step = 1; step < colBlocks; step *= 2) {
+            barrier.wait(cfg->id);
+            // par (base, base + step): base se queda con la primera mitad
+            int base = cb & ~(2 * step - 1);
+            if (!active || base + step >= colBlocks || (cb != base && cb != base + step)) continue;
+            
+            int mid = min(n, (n / 2 + ROWS_PER_LINE - 1) / ROWS_PER_LINE * ROWS_PER_LINE);
+            int from = (cb == base) ? 0 : mid;
+            int to = (cb == base) ? mid : n;
+            double* left = partials[rb * colBlocks + base];
+            const double* right = partials[rb * colBlocks + base + step];
+            double* dst = (2 * step >= colBlocks) ? out + r0 : left;   // ultimo paso: directo a y
+            for (int i = from; i < to; i++) {
+                dst[i] = left[i] + right[i];
             }
         }
+        return nullptr;
+    }
+    
+    bool visitTiles(int id, int threads, const MatrixView& mat, TileVisitor visit, void* ctx) override {
+        (void)threads;
+        int r0, r1, c0, c1;
+        if (tileBounds(id, mat, r0, r1, c0, c1)) {
+            visit(ctx, r0, r1, c0, c1);
+        }
+        return true;
+    }
+};
+
+// CSR: cada thread toma un rango contiguo de filas, de igual cantidad de
+// filas o de igual cantidad de no ceros
+class CsrStrategy : public MultiplicationStrategy {
+private:
+    bool balanceNnz;
+    
+public:
+    CsrStrategy(bool nnz) : balanceNnz(nnz) {}
+    
+    void executeSerial(MatrixData* data) override {
+        data->getCsr()->multiplyRows(0, data->getRows(), data->getInput(), data->getOutput());
+    }
+    
+    void* executeParallel(void* config) override {
+        ThreadConfig* cfg = (ThreadConfig*)config;
+        CsrMatrix* csr = cfg->data->getCsr();
+        int startRow, endRow;
+        
+        if (balanceNnz) {
+            startRow = csr->balancedRow(cfg->id, cfg->totalThreads);
+            endRow = csr->balancedRow(cfg->id + 1, cfg->totalThreads);
+        } else {
+            int chunkSize = csr->rows / cfg->totalThreads;
+            startRow = cfg->id * chunkSize;
+            endRow = (cfg->id == cfg->totalThreads - 1) ? csr->rows : (cfg->id + 1) * chunkSize;
+        }
         
+        csr->multiplyRows(startRow, endRow, cfg->data->getInput(), cfg->data->getOutput());
+        return nullptr;
+    }
+};
+
+// SELL-C-sigma: rangos de chunks con igual cantidad de elementos guardados
+class SellStrategy : public MultiplicationStrategy {
+public:
+    void executeSerial(MatrixData* data) override {
+        SellMatrix* sell = data->getSell();
+        sell->multiplyChunks(0, sell->numChunks, data->getInput(), data->getOutput());
+    }
+    
+    void* executeParallel(void* config) override {
+        ThreadConfig* cfg = (ThreadConfig*)config;
+        SellMatrix* sell = cfg->data->getSell();
+        int startChunk = sell->balancedChunk(cfg->id, cfg->totalThreads);
+        int endChunk = sell->balancedChunk(cfg->id + 1, cfg->totalThreads);
+        sell->multiplyChunks(startChunk, endChunk, cfg->data->getInput(), cfg->data->getOutput());
         return nullptr;
     }
 };
 
 //   Gestor de experimentos  
+// MATVEC_PRIMER_TOQUE=1: antes de medir cada estrategia la densa se copia
+// desde los workers que la van a leer (por defecto solo con mas de un nodo)
+static bool firstTouchPlacement = false;
+
 class BenchmarkManager {
 private:
     MultiplicationStrategy* strategy;
+    const bench_config* config;
+    ThreadPool* pool;
+    
+    struct SampleContext {
+        BenchmarkManager* bench;
+        MatrixData* data;
+        int numThreads;
+        void* (*threadFunc)(void*);
+    };
+    
+    static double serialSample(void* arg) {
+        SampleContext* ctx = (SampleContext*)arg;
+        return ctx->bench->measureSerialTime(ctx->data);
+    }
+    
+    static double parallelSample(void* arg) {
+        SampleContext* ctx = (SampleContext*)arg;
+        return ctx->bench->measureParallelTime(ctx->data, ctx->numThreads, ctx->threadFunc);
+    }
+    
+    // Primer toque: cada worker copia a la reserva nueva las partes que va a
+    // leer, asi sus paginas quedan en su nodo
+    struct PlacementTask {
+        MultiplicationStrategy* strategy;
+        MatrixView from;
+        const double* oldOut;
+        double* matrix;
+        double* out;
+        int id;
+        int threads;
+    };
+    
+    static void copyTile(void* ctx, int r0, int r1, int c0, int c1) {
+        PlacementTask* task = (PlacementTask*)ctx;
+        for (int r = r0; r < r1; r++) {
+            memcpy(task->matrix + (size_t)r * task->from.stride + c0, task->from.row(r) + c0,
+                   (size_t)(c1 - c0) * sizeof(double));
+            if (c0 == 0) task->out[r] = task->oldOut[r];
+        }
+    }
     
-    static void* threadWrapper(void* arg) {
-        ThreadConfig* cfg = (ThreadConfig*)arg;
+    static void* placementEntry(void* arg) {
+        PlacementTask* task = (PlacementTask*)arg;
+        task->strategy->visitTiles(task->id, task->threads, task->from, copyTile, task);
         return nullptr;
     }
     
+    static void ignoreTile(void*, int, int, int, int) {}
+    
 public:
-    BenchmarkManager(MultiplicationStrategy* s) : strategy(s) {}
+    BenchmarkManager(MultiplicationStrategy* s, const bench_config* cfg, ThreadPool* p)
+        : strategy(s), config(cfg), pool(p) {}
     
+    // Una sola corrida, en segundos de reloj de pared
     double measureSerialTime(MatrixData* data) {
-        auto t1 = high_resolution_clock::now();
+        double t1 = bench_ahora();
         strategy->executeSerial(data);
-        auto t2 = high_resolution_clock::now();
-        
-        auto elapsed = duration_cast<microseconds>(t2 - t1);
-        return elapsed.count() / 1000000.0;
+        double t2 = bench_ahora();
+        return t2 - t1;
     }
     
+    // Los workers del pool ya existen: solo se mide entre la barrera de
+    // arranque y la de fin, no el despertar ni la creacion de threads
     double measureParallelTime(MatrixData* data, int numThreads, 
                                void* (*threadFunc)(void*)) {
         data->resetOutput();
         
-        pthread_t* threads = new pthread_t[numThreads];
-        ThreadConfig* configs = new ThreadConfig[numThreads];
-        
-        auto t1 = high_resolution_clock::now();
-        
+        vector<ThreadConfig> configs(numThreads);
+        vector<void*> args(numThreads);
         for (int i = 0; i < numThreads; i++) {
             configs[i].id = i;
             configs[i].data = data;
+            configs[i].view = data->getView();
             configs[i].totalThreads = numThreads;
-            pthread_create(&threads[i], nullptr, threadFunc, &configs[i]);
+            args[i] = &configs[i];
         }
         
+        strategy->prepareParallel(data, numThreads);
+        return pool->runParallel(numThreads, threadFunc, args.data());
+    }
+    
+    // Calentamiento + repeticiones segun BENCH_WARMUP / BENCH_REPS
+    bench_stats benchmarkSerial(const string& name, MatrixData* data) {
+        SampleContext ctx = {this, data, 1, nullptr};
+        return bench_repetir(name.c_str(), config, serialSample, &ctx);
+    }
+    
+    // Mueve la densa e y a paginas tocadas primero por el worker que las lee
+    // en la estrategia actual. No hace nada si la estrategia no lee la densa.
+    void placePages(MatrixData* data, int numThreads) {
+        if (!data->hasDense()) return;
+        MatrixView view = data->getView();
+        strategy->prepareParallel(data, numThreads);
+        if (!strategy->visitTiles(0, numThreads, view, ignoreTile, nullptr)) return;
+        
+        vector<PlacementTask> tasks(numThreads);
+        vector<void*> args(numThreads);
+        double* matrix = MatrixData::allocateSlab(view.rows, view.stride);
+        double* out = MatrixData::allocateOutput(view.rows);
         for (int i = 0; i < numThreads; i++) {
-            pthread_join(threads[i], nullptr);
+            tasks[i] = {strategy, view, data->getOutput(), matrix, out, i, numThreads};
+            args[i] = &tasks[i];
         }
-        
-        auto t2 = high_resolution_clock::now();
-        auto elapsed = duration_cast<microseconds>(t2 - t1);
-        
-        delete[] threads;
-        delete[] configs;
-        
-        return elapsed.count() / 1000000.0;
+        pool->runParallel(numThreads, placementEntry, args.data());
+        data->adoptStorage(matrix, out);
+    }
+    
+    bench_stats benchmarkParallel(const string& name, MatrixData* data, int numThreads,
+                                  void* (*threadFunc)(void*)) {
+        if (firstTouchPlacement) {
+            placePages(data, numThreads);
+        }
+        SampleContext ctx = {this, data, numThreads, threadFunc};
+        return bench_repetir(name.c_str(), config, parallelSample, &ctx);
     }
     
     double computeEfficiency(double serialT, double parallelT, int threads) {
         return serialT / (parallelT * threads);
     }
+    
+    // Roofline: 2 FLOP por elemento; la matriz, x e y se recorren una vez
+    static double flopCount(int rows, int cols) {
+        return 2.0 * rows * (double)cols;
+    }
+    
+    static double byteCount(int rows, int cols) {
+        return 8.0 * ((double)rows * cols + rows + cols);
+    }
 };
 
 //   Funciones auxiliares para threads  
@@ -246,9 +930,537 @@ void* interleavedThreadFunc(void* arg) {
     return interleavedStrat.executeParallel(arg);
 }
 
-//   Clase para presentar resultados  
-class ResultPresenter {
-private:
+static BlockCyclicStrategy blockCyclicStrat(16);
+
+void* blockCyclicThreadFunc(void* arg) {
+    return blockCyclicStrat.executeParallel(arg);
+}
+
+static TiledStrategy columnStrat(false);
+static TiledStrategy tiledStrat(true);
+
+void* columnThreadFunc(void* arg) {
+    return columnStrat.executeParallel(arg);
+}
+
+void* tiledThreadFunc(void* arg) {
+    return tiledStrat.executeParallel(arg);
+}
+
+static DynamicStrategy dynamicStrat(false, 16);
+static DynamicStrategy guidedStrat(true, 16);
+
+void* dynamicThreadFunc(void* arg) {
+    return dynamicStrat.executeParallel(arg);
+}
+
+void* guidedThreadFunc(void* arg) {
+    return guidedStrat.executeParallel(arg);
+}
+
+static ReducedStrategy reducedStrat;
+
+void* reducedThreadFunc(void* arg) {
+    return reducedStrat.executeParallel(arg);
+}
+
+static CsrStrategy csrRowsStrat(false);
+static CsrStrategy csrNnzStrat(true);
+static SellStrategy sellStrat;
+
+void* csrRowsThreadFunc(void* arg) {
+    return csrRowsStrat.executeParallel(arg);
+}
+
+void* csrNnzThreadFunc(void* arg) {
+    return csrNnzStrat.executeParallel(arg);
+}
+
+void* sellThreadFunc(void* arg) {
+    return sellStrat.executeParallel(arg);
+}
+
+//   Varios vectores a la vez: Y = A * X con X de cols x k e Y de rows x k,
+//   los dos con los k valores de cada fila contiguos (X[c * k + j]). Cada
+//   elemento de A se carga una vez para k FMA en vez de una, asi el producto
+//   deja de estar limitado por el ancho de banda de la matriz.
+//
+//   Bloqueo: MULTI_ROW_BLOCK filas recorren juntas una franja de columnas
+//   cuyo X (franja x k) entra en ~32 KB de L1, y las k sumas de cada fila van
+//   en registros (k fijo por template para 4, 8, 16 y 32; k = 1 es el
+//   producto de siempre).
+static const int MULTI_ROW_BLOCK = 8;
+static const size_t MULTI_TILE_BYTES = 32 * 1024;
+
+struct MultiVector {
+    int k;
+    double* X;      // cols x k
+    double* Y;      // rows x k
+};
+
+static inline int multiColumnTile(int k) {
+    int tile = (int)(MULTI_TILE_BYTES / ((size_t)k * sizeof(double)));
+    return max(ROWS_PER_LINE, tile / ROWS_PER_LINE * ROWS_PER_LINE);
+}
+
+// MR filas a la vez: cada carga de X sirve para MR filas y las MR x K sumas
+// son cadenas de suma independientes (con una sola fila y K = 8 todo el
+// producto espera la latencia de uno o dos acumuladores).
+// multi_vec es del ancho de un registro del target: un vector mas ancho que
+// el hardware GCC lo arma pasando por la pila en cada operacion.
+#ifdef __AVX__
+static const int MULTI_LANES = 4;
+#else
+static const int MULTI_LANES = 2;
+#endif
+static const int MULTI_ACC_VECTORS = 8;    // acumuladores por micro-bloque (de 16 registros)
+typedef double multi_vec __attribute__((vector_size(MULTI_LANES * sizeof(double))));
+
+template <int K, int MR>
+static inline void multiRowsMicro(const MatrixView& mat, const double* X, double* Y, int r, int ct, int ce) {
+    const int V = K / MULTI_LANES;
+    const double* rows[MR];
+    multi_vec acc[MR][V];
+    multi_vec a0 = {};
+    for (int m = 0; m < MR; m++) {
+        rows[m] = mat.row(r + m);
+        for (int v = 0; v < V; v++) {
+            if (ct == 0) {
+                acc[m][v] = a0;
+            } else {
+                memcpy(&acc[m][v], Y + (size_t)(r + m) * K + MULTI_LANES * v, sizeof(multi_vec));
+            }
+        }
+    }
+    for (int c = ct; c < ce; c++) {
+        // X alineado a 64 y K multiplo de 4: cada fila de X empieza alineada
+        const multi_vec* x = (const multi_vec*)(X + (size_t)c * K);
+        for (int m = 0; m < MR; m++) {
+            double a = rows[m][c];
+            for (int v = 0; v < V; v++) {
+                acc[m][v] += a * x[v];
+            }
+        }
+    }
+    for (int m = 0; m < MR; m++) {
+        memcpy(Y + (size_t)(r + m) * K, acc[m], sizeof(acc[m]));
+    }
+}
+
+template <int K>
+static void multiRowRangeFixed(const MatrixView& mat, const double* X, double* Y, int begin, int end) {
+    const int V = K / MULTI_LANES;
+    const int MR = (V >= MULTI_ACC_VECTORS) ? 1 : MULTI_ACC_VECTORS / V;
+    int tile = multiColumnTile(K);
+    for (int rb = begin; rb < end; rb += MULTI_ROW_BLOCK) {
+        int re = min(end, rb + MULTI_ROW_BLOCK);
+        for (int ct = 0; ct < mat.cols; ct += tile) {
+            int ce = min(mat.cols, ct + tile);
+            int r = rb;
+            for (; r + MR <= re; r += MR) {
+                multiRowsMicro<K, MR>(mat, X, Y, r, ct, ce);
+            }
+            for (; r < re; r++) {
+                multiRowsMicro<K, 1>(mat, X, Y, r, ct, ce);
+            }
+        }
+    }
+}
+
+// k cualquiera: mismo bloqueo, las sumas en Y (en L1) en vez de registros
+static void multiRowRangeGeneric(const MatrixView& mat, const double* X, double* Y, int k, int begin, int end) {
+    int tile = multiColumnTile(k);
+    for (int rb = begin; rb < end; rb += MULTI_ROW_BLOCK) {
+        int re = min(end, rb + MULTI_ROW_BLOCK);
+        for (int r = rb; r < re; r++) {
+            memset(Y + (size_t)r * k, 0, k * sizeof(double));
+        }
+        for (int ct = 0; ct < mat.cols; ct += tile) {
+            int ce = min(mat.cols, ct + tile);
+            for (int r = rb; r < re; r++) {
+                const double* row = mat.row(r);
+                double* y = Y + (size_t)r * k;
+                for (int c = ct; c < ce; c++) {
+                    double a = row[c];
+                    const double* x = X + (size_t)c * k;
+                    for (int j = 0; j < k; j++) {
+                        y[j] += a * x[j];
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void multiRowRange(const MatrixView& mat, const MultiVector& mv, int begin, int end) {
+    switch (mv.k) {
+        case 1:  denseRowRange(mat, mv.X, mv.Y, begin, end); break;   // X e Y son vectores comunes
+        case 4:  multiRowRangeFixed<4>(mat, mv.X, mv.Y, begin, end); break;
+        case 8:  multiRowRangeFixed<8>(mat, mv.X, mv.Y, begin, end); break;
+        case 16: multiRowRangeFixed<16>(mat, mv.X, mv.Y, begin, end); break;
+        case 32: multiRowRangeFixed<32>(mat, mv.X, mv.Y, begin, end); break;
+        default: multiRowRangeGeneric(mat, mv.X, mv.Y, mv.k, begin, end); break;
+    }
+}
+
+//   Corre Y = A * X con el reparto de filas de cualquier estrategia densa
+//   (visitTiles); las que parten columnas (tiles 2D) no aplican porque
+//   necesitarian un Y parcial por thread
+class MultiVectorBenchmark {
+private:
+    struct Task {
+        MultiplicationStrategy* strategy;
+        MatrixView mat;
+        const MultiVector* mv;
+        int id;
+        int threads;
+    };
+    
+    struct Context {
+        MultiplicationStrategy* strategy;
+        MatrixData* data;
+        MultiVector* mv;
+        ThreadPool* pool;
+        int threads;
+    };
+    
+    static void multiplyTile(void* arg, int r0, int r1, int c0, int c1) {
+        (void)c0; (void)c1;
+        Task* task = (Task*)arg;
+        multiRowRange(task->mat, *task->mv, r0, r1);
+    }
+    
+    static void* taskEntry(void* arg) {
+        Task* task = (Task*)arg;
+        task->strategy->visitTiles(task->id, task->threads, task->mat, multiplyTile, task);
+        return nullptr;
+    }
+    
+    struct WidthCheck {
+        int cols;
+        bool fullRows;
+    };
+    
+    static void checkTile(void* arg, int r0, int r1, int c0, int c1) {
+        (void)r0; (void)r1;
+        WidthCheck* check = (WidthCheck*)arg;
+        check->fullRows = check->fullRows && c0 == 0 && c1 == check->cols;
+    }
+    
+    static double sample(void* arg) {
+        Context* ctx = (Context*)arg;
+        MatrixView mat = ctx->data->getView();
+        if (ctx->threads == 1) {
+            double t1 = bench_ahora();
+            multiRowRange(mat, *ctx->mv, 0, mat.rows);
+            return bench_ahora() - t1;
+        }
+        ctx->strategy->prepareParallel(ctx->data, ctx->threads);
+        vector<Task> tasks(ctx->threads);
+        vector<void*> args(ctx->threads);
+        for (int i = 0; i < ctx->threads; i++) {
+            tasks[i] = {ctx->strategy, mat, ctx->mv, i, ctx->threads};
+            args[i] = &tasks[i];
+        }
+        return ctx->pool->runParallel(ctx->threads, taskEntry, args.data());
+    }
+    
+public:
+    // Cada thread de 'strategy' multiplica filas enteras
+    static bool supports(MultiplicationStrategy* strategy, MatrixData* data, int threads) {
+        MatrixView mat = data->getView();
+        strategy->prepareParallel(data, threads);
+        WidthCheck check = {mat.cols, true};
+        for (int i = 0; i < threads; i++) {
+            if (!strategy->visitTiles(i, threads, mat, checkTile, &check)) return false;
+        }
+        return check.fullRows;
+    }
+    
+    static MultiVector create(int rows, int cols, int k) {
+        MultiVector mv;
+        mv.k = k;
+        mv.X = MatrixData::allocateSlab(cols, k);
+        mv.Y = MatrixData::allocateSlab(rows, k);
+        CounterRng(dataSeed, STREAM_MULTI_X).fillUniform(mv.X, 0, (size_t)cols * k, -1.0, 1.0);
+        memset(mv.Y, 0, (size_t)rows * k * sizeof(double));
+        return mv;
+    }
+    
+    static void release(MultiVector& mv) {
+        free(mv.X);
+        free(mv.Y);
+    }
+    
+    static bench_stats run(const bench_config* config, const string& name, MultiplicationStrategy* strategy,
+                           MatrixData* data, MultiVector* mv, ThreadPool* pool, int threads) {
+        Context ctx = {strategy, data, mv, pool, threads};
+        return bench_repetir(name.c_str(), config, sample, &ctx);
+    }
+};
+
+//   Iteracion de potencia: x <- A x / ||A x|| muchas veces seguidas, como en
+//   PageRank. Los workers se quedan en una sola region del pool durante todas
+//   las iteraciones (no se despierta a nadie por producto) y se sincronizan
+//   con una sola barrera por iteracion:
+//   - la iteracion k lee buffer[k % 2] y escribe sus filas de buffer[(k+1) % 2];
+//   - cada thread deja la suma de cuadrados de sus filas en partial[k % 2];
+//   - pasada la barrera todos suman los parciales en el mismo orden (la misma
+//     norma en cada thread) y la iteracion k+1 divide por ella al escribir,
+//     asi normalizar no necesita otra pasada ni otra barrera.
+//   Los parciales alternan de a dos: el de k se lee despues de la barrera k y
+//   el proximo que lo pisa es el de k+2, que se escribe pasada la barrera k+1.
+//   Barrier es SenseBarrier o TreeBarrier (thread_pool.h).
+struct PowerResult {
+    double seconds;     // region completa
+    double kernel;      // promedio por thread en el producto y su parcial
+    double waiting;     // promedio por thread en la barrera
+    double norm;        // ||A x|| de la ultima iteracion (|lambda| aprox.)
+    vector<double> x;   // A x de la ultima iteracion, sin normalizar
+};
+
+template <class Barrier>
+class PowerIteration {
+private:
+    struct alignas(64) WorkerTimes {
+        double kernel;
+        double waiting;
+    };
+    
+    struct alignas(64) Partial {
+        double sumSquares;
+    };
+    
+    struct Shared {
+        MatrixView mat;
+        double* buffer[2];
+        vector<Partial> partial[2];
+        vector<WorkerTimes> times;
+        Barrier barrier;
+        int threads;
+        int iterations;
+        double norm;
+    };
+    
+    struct Task {
+        Shared* shared;
+        int id;
+    };
+    
+    struct Context {
+        ThreadPool* pool;
+        MatrixData* data;
+        int threads;
+        int iterations;
+        PowerResult last;
+    };
+    
+    static double normOf(const vector<Partial>& partial, int threads) {
+        double sum = 0.0;
+        for (int i = 0; i < threads; i++) sum += partial[i].sumSquares;
+        return sqrt(sum);
+    }
+    
+    static void* workerEntry(void* arg) {
+        Task* task = (Task*)arg;
+        Shared* sh = task->shared;
+        const MatrixView& mat = sh->mat;
+        int begin, end;
+        BlockStrategy::rowRange(task->id, sh->threads, mat.rows, begin, end);
+        
+        double scale = 1.0;
+        double kernel = 0.0, waiting = 0.0;
+        for (int k = 0; k < sh->iterations; k++) {
+            double t0 = bench_ahora();
+            double* y = sh->buffer[(k + 1) & 1];
+            denseRowRange(mat, sh->buffer[k & 1], y, begin, end);
+            double sum = 0.0;
+            for (int r = begin; r < end; r++) {
+                y[r] *= scale;
+                sum += y[r] * y[r];
+            }
+            sh->partial[k & 1][task->id].sumSquares = sum;
+            double t1 = bench_ahora();
+            sh->barrier.wait(task->id);
+            kernel += t1 - t0;
+            waiting += bench_ahora() - t1;
+            scale = 1.0 / normOf(sh->partial[k & 1], sh->threads);
+        }
+        
+        sh->times[task->id].kernel = kernel;
+        sh->times[task->id].waiting = waiting;
+        if (task->id == 0) sh->norm = 1.0 / scale;
+        return nullptr;
+    }
+    
+    static double sample(void* arg) {
+        Context* ctx = (Context*)arg;
+        ctx->last = run(ctx->pool, ctx->data, ctx->threads, ctx->iterations);
+        return ctx->last.seconds;
+    }
+    
+public:
+    // data cuadrada; x inicial = el x de data
+    static PowerResult run(ThreadPool* pool, MatrixData* data, int threads, int iterations) {
+        MatrixView mat = data->getView();
+        Shared sh;
+        sh.mat = mat;
+        sh.buffer[0] = MatrixData::allocateOutput(mat.rows);
+        sh.buffer[1] = MatrixData::allocateOutput(mat.rows);
+        memcpy(sh.buffer[0], data->getInput(), mat.rows * sizeof(double));
+        sh.partial[0].assign(threads, Partial{0.0});
+        sh.partial[1].assign(threads, Partial{0.0});
+        sh.times.assign(threads, WorkerTimes{0.0, 0.0});
+        sh.barrier.reset(threads);
+        sh.threads = threads;
+        sh.iterations = iterations;
+        sh.norm = 0.0;
+        
+        vector<Task> tasks(threads);
+        vector<void*> args(threads);
+        for (int i = 0; i < threads; i++) {
+            tasks[i] = {&sh, i};
+            args[i] = &tasks[i];
+        }
+        PowerResult result;
+        result.seconds = pool->runParallel(threads, workerEntry, args.data());
+        result.kernel = 0.0;
+        result.waiting = 0.0;
+        for (int i = 0; i < threads; i++) {
+            result.kernel += sh.times[i].kernel / threads;
+            result.waiting += sh.times[i].waiting / threads;
+        }
+        result.norm = sh.norm;
+        const double* last = sh.buffer[iterations & 1];
+        result.x.assign(last, last + mat.rows);
+        free(sh.buffer[0]);
+        free(sh.buffer[1]);
+        return result;
+    }
+    
+    // Mediana de la region completa; 'last' queda con la ultima repeticion
+    static bench_stats benchmark(const bench_config* config, const string& name, ThreadPool* pool,
+                                 MatrixData* data, int threads, int iterations, PowerResult& last) {
+        Context ctx = {pool, data, threads, iterations, PowerResult()};
+        bench_stats st = bench_repetir(name.c_str(), config, sample, &ctx);
+        last = ctx.last;
+        return st;
+    }
+};
+
+//   Layout anterior (new[] por fila) contra la reserva unica de MatrixData:
+//   construccion (reservar y escribir cada elemento) y producto serial
+class LayoutBenchmark {
+private:
+    struct Context {
+        int rows;
+        int cols;
+        double** rowPtrs;
+        double* slab;
+        size_t stride;
+        double* in;
+        double* out;
+    };
+    
+    static void freeRows(Context* ctx) {
+        for (int i = 0; i < ctx->rows; i++) {
+            delete[] ctx->rowPtrs[i];
+        }
+        delete[] ctx->rowPtrs;
+        ctx->rowPtrs = nullptr;
+    }
+    
+    static double buildRowsSample(void* arg) {
+        Context* ctx = (Context*)arg;
+        double t1 = bench_ahora();
+        ctx->rowPtrs = new double*[ctx->rows];
+        for (int i = 0; i < ctx->rows; i++) {
+            ctx->rowPtrs[i] = new double[ctx->cols];
+            for (int j = 0; j < ctx->cols; j++) {
+                ctx->rowPtrs[i][j] = 1.0;
+            }
+        }
+        double t2 = bench_ahora();
+        freeRows(ctx);
+        return t2 - t1;
+    }
+    
+    static double buildSlabSample(void* arg) {
+        Context* ctx = (Context*)arg;
+        double t1 = bench_ahora();
+        size_t bytes = (size_t)ctx->rows * ctx->stride * sizeof(double);
+        double* slab = (double*) aligned_alloc(64, (bytes + 63) / 64 * 64);
+        for (int i = 0; i < ctx->rows; i++) {
+            double* row = slab + (size_t)i * ctx->stride;
+            for (int j = 0; j < ctx->cols; j++) {
+                row[j] = 1.0;
+            }
+        }
+        double t2 = bench_ahora();
+        free(slab);
+        return t2 - t1;
+    }
+    
+    static double kernelRowsSample(void* arg) {
+        Context* ctx = (Context*)arg;
+        double t1 = bench_ahora();
+        for (int r = 0; r < ctx->rows; r++) {
+            ctx->out[r] = 0.0;
+            for (int c = 0; c < ctx->cols; c++) {
+                ctx->out[r] += ctx->rowPtrs[r][c] * ctx->in[c];
+            }
+        }
+        return bench_ahora() - t1;
+    }
+    
+    static double kernelSlabSample(void* arg) {
+        Context* ctx = (Context*)arg;
+        MatrixView mat = {ctx->slab, ctx->stride, ctx->rows, ctx->cols};
+        double t1 = bench_ahora();
+        for (int r = 0; r < mat.rows; r++) {
+            const double* row = mat.row(r);
+            ctx->out[r] = 0.0;
+            for (int c = 0; c < mat.cols; c++) {
+                ctx->out[r] += row[c] * ctx->in[c];
+            }
+        }
+        return bench_ahora() - t1;
+    }
+    
+public:
+    // times: construir filas, construir bloque, kernel filas, kernel bloque
+    static void run(const bench_config* config, int rows, int cols, const string& caseName, double times[4]) {
+        Context ctx = {rows, cols, nullptr, nullptr, MatrixData::strideFor(cols), nullptr, nullptr};
+        string prefix = "layout/" + caseName + "/";
+        bench_stats s[4];
+        
+        s[0] = bench_repetir((prefix + "construir_filas").c_str(), config, buildRowsSample, &ctx);
+        s[1] = bench_repetir((prefix + "construir_bloque").c_str(), config, buildSlabSample, &ctx);
+        
+        // mismos valores en los dos layouts para el producto
+        MatrixData data(rows, cols);
+        ctx.slab = data.getRow(0);
+        ctx.in = data.getInput();
+        ctx.out = data.getOutput();
+        ctx.rowPtrs = new double*[rows];
+        for (int i = 0; i < rows; i++) {
+            ctx.rowPtrs[i] = new double[cols];
+            memcpy(ctx.rowPtrs[i], data.getRow(i), cols * sizeof(double));
+        }
+        s[2] = bench_repetir((prefix + "kernel_filas").c_str(), config, kernelRowsSample, &ctx);
+        s[3] = bench_repetir((prefix + "kernel_bloque").c_str(), config, kernelSlabSample, &ctx);
+        freeRows(&ctx);
+        
+        for (int i = 0; i < 4; i++) {
+            bench_registrar(config, &s[i]);
+            times[i] = s[i].mediana;
+        }
+    }
+};
+
+//   Clase para presentar resultados  
+class ResultPresenter {
+private:
     struct TestCase {
         int rows, cols;
         string label;
@@ -262,11 +1474,178 @@ private:
     
     int threadOptions[3] = {1, 2, 4};
     
+    const bench_config* config;
+    ThreadPool pool;    // workers para el mayor numero de threads probado
+    
+    // Filas de la tabla principal (matriz densa)
+    struct DenseStrategy {
+        const char* label;
+        const char* record;
+        MultiplicationStrategy* strategy;
+        void* (*threadFunc)(void*);
+    };
+    
+    static const int NUM_DENSE_STRATEGIES = 7;
+    DenseStrategy denseStrategies[NUM_DENSE_STRATEGIES] = {
+        {"Division por Filas", "filas", &blockStrat, blockThreadFunc},
+        {"Division Ciclica", "ciclica", &interleavedStrat, interleavedThreadFunc},
+        {"Bloque-Ciclica", "bloque_ciclica", &blockCyclicStrat, blockCyclicThreadFunc},
+        {"Dinamica", "dinamica", &dynamicStrat, dynamicThreadFunc},
+        {"Guiada", "guiada", &guidedStrat, guidedThreadFunc},
+        {"Division por Columnas", "columnas", &columnStrat, columnThreadFunc},
+        {"Tiles 2D", "tiles_2d", &tiledStrat, tiledThreadFunc}
+    };
+    
+    // Formatos de la comparacion densa vs dispersa
+    struct SparseFormat {
+        const char* label;
+        const char* record;
+        MultiplicationStrategy* strategy;
+        void* (*threadFunc)(void*);
+    };
+    
+    static const int NUM_SPARSE_FORMATS = 4;
+    SparseFormat sparseFormats[NUM_SPARSE_FORMATS] = {
+        {"Densa, filas", "densa", &blockStrat, blockThreadFunc},
+        {"CSR, filas iguales", "csr_filas", &csrRowsStrat, csrRowsThreadFunc},
+        {"CSR, nnz balanceado", "csr_nnz", &csrNnzStrat, csrNnzThreadFunc},
+        {"SELL-C-sigma", "sell", &sellStrat, sellThreadFunc}
+    };
+    
+    struct SparseCase {
+        string label;
+        long nnz;
+        double fill;
+        double maxDiff;
+        double times[NUM_SPARSE_FORMATS][3];   // -1 si el formato no aplica
+    };
+    
+    string recordName(const char* strategyName, int tc, int threads) {
+        return string("matvec/") + strategyName + "/" + to_string(testCases[tc].rows) + "x" +
+               to_string(testCases[tc].cols) + "/t=" + to_string(threads);
+    }
+    
+    // Informe de ubicacion: una linea por worker y dimension
+    struct PlacementReport {
+        int cpu;
+        int cpuNode;
+        int r0, r1;
+        MatrixData* data;
+        string pageNodes;
+    };
+    
+    string affinity;
+    vector<string> placementLines;
+    string shareLines[NUM_DENSE_STRATEGIES][3];   // reparto por thread (recordShare)
+    
+    static void* placementProbe(void* arg) {
+        PlacementReport* rep = (PlacementReport*)arg;
+        rep->cpu = Affinity::currentCpu(&rep->cpuNode);
+        // nodos distintos entre hasta 8 paginas repartidas en el rango
+        vector<int> nodes;
+        int n = rep->r1 - rep->r0;
+        for (int k = 0; k < 8 && n > 0; k++) {
+            int node = Affinity::pageNode(rep->data->getRow(rep->r0 + (int)((long)n * k / 8)));
+            if (find(nodes.begin(), nodes.end(), node) == nodes.end()) nodes.push_back(node);
+        }
+        for (size_t i = 0; i < nodes.size(); i++) {
+            rep->pageNodes += (i > 0 ? "," : "") + (nodes[i] < 0 ? string("?") : to_string(nodes[i]));
+        }
+        return nullptr;
+    }
+    
+    // Trabajo y espera de cada thread en la ultima repeticion de 'strategy'
+    // (la espera es la region del pool menos lo que el thread estuvo adentro)
+    void recordShare(int s, int tc, MatrixData* data, int threads) {
+        MultiplicationStrategy* strategy = denseStrategies[s].strategy;
+        MatrixView mat = data->getView();
+        double total = (double)mat.rows * mat.cols;
+        double span = pool.lastRegionSpan();
+        ostringstream work, idle, chunks;
+        for (int i = 0; i < threads; i++) {
+            long done = strategy->elementsDone(i, threads, mat);
+            double wait = span > 0.0 ? (span - pool.lastRegionBusy(i)) / span : 0.0;
+            work << setw(4);
+            if (done < 0) work << "?";
+            else work << (int)lround(100.0 * done / total);
+            idle << setw(4) << (int)lround(100.0 * wait);
+            if (strategy == &dynamicStrat || strategy == &guidedStrat) {
+                chunks << " " << ((DynamicStrategy*)strategy)->chunksDone(i);
+            }
+        }
+        ostringstream line;
+        line << "| " << left << setw(22) << (tc == 0 ? denseStrategyLabel(s) : "") << " | " << setw(14)
+             << testCases[tc].label << " | " << setw(20) << work.str() << " | " << setw(20) << idle.str()
+             << " | " << setw(25) << (chunks.str().empty() ? " -" : chunks.str()) << right << " |";
+        shareLines[s][tc] = line.str();
+    }
+    
+    void displayShares() {
+        cout << "\n=== reparto por thread con " << threadOptions[2] << " threads (ultima repeticion) ===" << endl;
+        cout << "| Estrategia             | Dimension      | trabajo %            | espera %             | pedidos                   |" << endl;
+        cout << "|------------------------|----------------|----------------------|----------------------|---------------------------|" << endl;
+        for (int s = 0; s < NUM_DENSE_STRATEGIES; s++) {
+            if (s > 0) {
+                cout << "|------------------------|----------------|----------------------|----------------------|---------------------------|" << endl;
+            }
+            for (int tc = 0; tc < 3; tc++) cout << shareLines[s][tc] << endl;
+        }
+        cout << "trabajo: % de los elementos de la matriz que multiplico cada thread" << endl;
+        cout << "espera: % de la region paralela que cada thread no estuvo trabajando (arranque tarde o" << endl;
+        cout << "esperando al ultimo); pedidos: rangos que tomo del contador compartido" << endl;
+    }
+    
+    // Donde corre cada worker y donde estan las paginas de sus filas, con la
+    // division por filas y el mayor numero de threads
+    void recordPlacement(MatrixData* data, int tc) {
+        int threads = threadOptions[2];
+        BenchmarkManager bench(&blockStrat, config, &pool);
+        if (firstTouchPlacement) {
+            bench.placePages(data, threads);
+        }
+        vector<PlacementReport> reports(threads);
+        vector<void*> args(threads);
+        for (int i = 0; i < threads; i++) {
+            reports[i] = {-1, -1, 0, 0, data, ""};
+            BlockStrategy::rowRange(i, threads, data->getRows(), reports[i].r0, reports[i].r1);
+            args[i] = &reports[i];
+        }
+        pool.runParallel(threads, placementProbe, args.data());
+        
+        for (int i = 0; i < threads; i++) {
+            ostringstream line;
+            line << "| " << left << setw(14) << (i == 0 ? testCases[tc].label : "") << right << " | "
+                 << setw(6) << i << " | " << setw(4) << reports[i].cpu << " | " << setw(9) << reports[i].cpuNode
+                 << " | " << setw(21) << (to_string(reports[i].r0) + "-" + to_string(reports[i].r1))
+                 << " | " << setw(13) << reports[i].pageNodes << " |";
+            placementLines.push_back(line.str());
+        }
+    }
+    
+    void displayPlacement() {
+        cout << "\n=== ubicacion NUMA (" << Affinity::numaNodes() << " nodo(s), afinidad " << affinity
+             << ", primer toque " << (firstTouchPlacement ? "si" : "no") << ") ===" << endl;
+        cout << "| Dimension      | worker |  cpu | nodo cpu  | filas                 | nodo paginas  |" << endl;
+        cout << "|----------------|--------|------|-----------|-----------------------|---------------|" << endl;
+        for (const string& line : placementLines) cout << line << endl;
+        cout << "nodo paginas: nodos de hasta 8 paginas de sus filas (? = get_mempolicy no disponible)" << endl;
+    }
+    
 public:
+    ResultPresenter(const bench_config* cfg) : config(cfg), pool(threadOptions[2]) {
+        affinity = Affinity::pinPool(pool);
+        firstTouchPlacement = bench_entero_entorno("MATVEC_PRIMER_TOQUE", Affinity::numaNodes() > 1 ? 1 : 0, 0) != 0;
+        dataSeed = CounterRng::seedFromEnv();
+    }
+    
     void displayHeader() {
         cout << "\n=== analisis de rendimiento - matriz-vector multiplication ===" << endl;
-        cout << "implementaciones: division por filas, division ciclica" << endl;
+        cout << "implementaciones: division por filas, division ciclica, bloque-ciclica, dinamica, guiada," << endl;
+        cout << "por columnas, tiles 2D" << endl;
         cout << "dimensiones como en el libro del capitulo 4" << endl;
+        cout << "afinidad (LAB04_AFINIDAD): " << affinity << ", primer toque (MATVEC_PRIMER_TOQUE): "
+             << (firstTouchPlacement ? "si" : "no") << endl;
+        cout << "semilla de los datos (LAB04_SEMILLA): " << dataSeed << endl;
         cout << "\n";
         
         cout << "    ======" << endl;
@@ -279,112 +1658,523 @@ public:
     }
     
     void runExperiments() {
-        double blockResults[3][3];
-        double interleavedResults[3][3];
+        double results[NUM_DENSE_STRATEGIES][3][3];
         double baselineTimes[3];
         
-        BlockStrategy blockStrat;
-        InterleavedStrategy interleavedStrat;
+        blockCyclicStrat.setChunkLines(bench_entero_entorno("MATVEC_BLOQUE_LINEAS", 16, 1));
+        dynamicStrat.setChunkLines(blockCyclicStrat.getChunkLines());
         
         for (int tc = 0; tc < 3; tc++) {
             cout << "procesando dimension " << testCases[tc].label << "..." << endl;
             
-            MatrixData* data = new MatrixData(testCases[tc].rows, testCases[tc].cols);
-            BenchmarkManager blockBench(&blockStrat);
-            BenchmarkManager interleavedBench(&interleavedStrat);
+            MatrixData* data = new MatrixData(testCases[tc].rows, testCases[tc].cols, &pool);
+            BenchmarkManager serialBench(&blockStrat, config, &pool);
             
-            baselineTimes[tc] = blockBench.measureSerialTime(data);
+            bench_stats serial = serialBench.benchmarkSerial(recordName("serial", tc, 1), data);
+            bench_registrar(config, &serial);
+            baselineTimes[tc] = serial.mediana;
             
-            for (int t = 0; t < 3; t++) {
-                if (threadOptions[t] == 1) {
-                    blockResults[tc][t] = baselineTimes[tc];
-                    interleavedResults[tc][t] = baselineTimes[tc];
-                } else {
-                    blockResults[tc][t] = blockBench.measureParallelTime(
-                        data, threadOptions[t], blockThreadFunc);
-                    interleavedResults[tc][t] = interleavedBench.measureParallelTime(
-                        data, threadOptions[t], interleavedThreadFunc);
+            for (int s = 0; s < NUM_DENSE_STRATEGIES; s++) {
+                BenchmarkManager bench(denseStrategies[s].strategy, config, &pool);
+                for (int t = 0; t < 3; t++) {
+                    if (threadOptions[t] == 1) {
+                        results[s][tc][t] = baselineTimes[tc];
+                        continue;
+                    }
+                    bench_stats b = bench.benchmarkParallel(
+                        recordName(denseStrategies[s].record, tc, threadOptions[t]), data,
+                        threadOptions[t], denseStrategies[s].threadFunc);
+                    bench_registrar(config, &b);
+                    results[s][tc][t] = b.mediana;
+                    if (t == 2) recordShare(s, tc, data, threadOptions[t]);
                 }
             }
             
+            recordPlacement(data, tc);
             delete data;
         }
         
-        displayResults(blockResults, interleavedResults, baselineTimes);
+        displayResults(results, baselineTimes);
+        displayShares();
+        displayPlacement();
+        displayRoofline(results);
+    }
+    
+    // Caracteriza la maquina con cada numero de threads y ubica cada medicion
+    void displayRoofline(double results[NUM_DENSE_STRATEGIES][3][3]) {
+        for (int t = 0; t < 3; t++) {
+            roofline_maquina machine = roofline_caracterizar(threadOptions[t]);
+            if (!machine.activo) return;
+            
+            cout << "\n" << flush;
+            roofline_imprimir_maquina(&machine);
+            roofline_cabecera();
+            for (int tc = 0; tc < 3; tc++) {
+                double flops = BenchmarkManager::flopCount(testCases[tc].rows, testCases[tc].cols);
+                double bytes = BenchmarkManager::byteCount(testCases[tc].rows, testCases[tc].cols);
+                for (int s = 0; s < NUM_DENSE_STRATEGIES; s++) {
+                    roofline_reportar(&machine, recordName(denseStrategies[s].record, tc, threadOptions[t]).c_str(),
+                                      flops, bytes, results[s][tc][t]);
+                }
+            }
+            fflush(stdout);
+        }
     }
     
-    void displayResults(double block[3][3], double interleaved[3][3], double baseline[3]) {
-        BenchmarkManager dummyBench(&blockStrat);
+    void displayResults(double results[NUM_DENSE_STRATEGIES][3][3], double baseline[3]) {
+        BenchmarkManager dummyBench(&blockStrat, config, &pool);
         
-        cout << "| 1 (Division por Filas)           |";
-        for (int i = 0; i < 3; i++) {
-            cout << fixed << setprecision(3) << setw(6) << block[i][0] << " 1.000 |";
+        for (int s = 0; s < NUM_DENSE_STRATEGIES; s++) {
+            if (s > 0) {
+                cout << "|----------------------------------|---------------|--------------|----------------|" << endl;
+            }
+            for (int t = 0; t < 3; t++) {
+                string head = to_string(threadOptions[t]);
+                if (t == 0) head += string(" (") + denseStrategyLabel(s) + ")";
+                cout << "| " << left << setw(33) << head << right << "|";
+                for (int i = 0; i < 3; i++) {
+                    double eff = dummyBench.computeEfficiency(baseline[i], results[s][i][t], threadOptions[t]);
+                    cout << fixed << setprecision(3) << setw(6) << results[s][i][t] << " " << setw(5) << eff << " |";
+                }
+                cout << endl;
+            }
         }
-        cout << endl;
         
-        cout << "| 2                                |";
+        cout << "    ======" << endl;
+        cout << "grilla de tiles 2D (franjas de filas x franjas de columnas):";
         for (int i = 0; i < 3; i++) {
-            double eff = dummyBench.computeEfficiency(baseline[i], block[i][1], 2);
-            cout << fixed << setprecision(3) << setw(6) << block[i][1] << " " << setw(5) << eff << " |";
+            cout << "\n  " << testCases[i].label << ":";
+            for (int t = 1; t < 3; t++) {
+                int rb, cb;
+                TiledStrategy::chooseGrid(testCases[i].rows, testCases[i].cols, threadOptions[t], rb, cb);
+                cout << " t=" << threadOptions[t] << " " << rb << "x" << cb;
+            }
         }
         cout << endl;
+    }
+    
+    string denseStrategyLabel(int s) {
+        if (denseStrategies[s].strategy == &blockCyclicStrat || denseStrategies[s].strategy == &dynamicStrat) {
+            return string(denseStrategies[s].label) + " " + to_string(blockCyclicStrat.getChunkLines()) + " lin.";
+        }
+        return denseStrategies[s].label;
+    }
+    
+    // Mismos tres tamaños con ~density de no ceros, y opcionalmente una matriz
+    // Matrix Market (SPMV_MTX), en formato denso y disperso lado a lado
+    void runSparseExperiments() {
+        const char* densityEnv = getenv("SPMV_DENSIDAD");
+        double density = (densityEnv != nullptr && atof(densityEnv) > 0.0) ? atof(densityEnv) / 100.0 : 0.05;
+        int sigma = bench_entero_entorno("SPMV_SIGMA", 256, 1);
+        vector<SparseCase> cases;
         
-        cout << "| 4                                |";
-        for (int i = 0; i < 3; i++) {
-            double eff = dummyBench.computeEfficiency(baseline[i], block[i][2], 4);
-            cout << fixed << setprecision(3) << setw(6) << block[i][2] << " " << setw(5) << eff << " |";
+        for (int tc = 0; tc < 3; tc++) {
+            cout << "procesando dimension " << testCases[tc].label << " dispersa..." << endl;
+            MatrixData* data = new MatrixData(testCases[tc].rows, testCases[tc].cols, &pool);
+            data->makeSparse(density, sigma);
+            cases.push_back(measureSparseCase(data, testCases[tc].label,
+                                              to_string(testCases[tc].rows) + "x" + to_string(testCases[tc].cols)));
+            delete data;
         }
-        cout << endl;
         
-        cout << "|----------------------------------|---------------|--------------|----------------|" << endl;
+        const char* path = getenv("SPMV_MTX");
+        if (path != nullptr && path[0] != '\0') {
+            CsrMatrix* loaded = new CsrMatrix();
+            string error;
+            if (!loaded->loadMatrixMarket(path, error)) {
+                cerr << "SPMV_MTX: " << path << ": " << error << endl;
+                delete loaded;
+            } else {
+                // la copia densa solo si entra en SPMV_DENSA_MB
+                double denseMb = 8.0 * loaded->rows * (double)loaded->cols / (1024.0 * 1024.0);
+                bool withDense = denseMb <= bench_entero_entorno("SPMV_DENSA_MB", 1024, 0);
+                string name = path;
+                size_t slash = name.find_last_of('/');
+                if (slash != string::npos) name = name.substr(slash + 1);
+                cout << "procesando " << name << "..." << endl;
+                MatrixData* data = new MatrixData(loaded, withDense, sigma);
+                cases.push_back(measureSparseCase(data, name, name));
+                delete data;
+            }
+        }
         
-        cout << "| 1 (Division Ciclica)             |";
-        for (int i = 0; i < 3; i++) {
-            cout << fixed << setprecision(3) << setw(6) << interleaved[i][0] << " 1.000 |";
+        displaySparse(cases, density, sigma);
+    }
+    
+    SparseCase measureSparseCase(MatrixData* data, const string& label, const string& recordCase) {
+        SparseCase result;
+        result.label = label;
+        result.nnz = data->getCsr()->nnz();
+        result.fill = data->getSell()->fillRatio(result.nnz);
+        result.maxDiff = 0.0;
+        
+        // referencia: la densa si existe, si no CSR serial
+        int rows = data->getRows();
+        vector<double> reference(rows);
+        if (data->hasDense()) {
+            blockStrat.executeSerial(data);
+        } else {
+            csrRowsStrat.executeSerial(data);
+        }
+        copy(data->getOutput(), data->getOutput() + rows, reference.begin());
+        
+        for (int f = 0; f < NUM_SPARSE_FORMATS; f++) {
+            if (sparseFormats[f].strategy == &blockStrat && !data->hasDense()) {
+                for (int t = 0; t < 3; t++) result.times[f][t] = -1.0;
+                continue;
+            }
+            BenchmarkManager bench(sparseFormats[f].strategy, config, &pool);
+            for (int t = 0; t < 3; t++) {
+                string name = string("spmv/") + sparseFormats[f].record + "/" + recordCase +
+                              "/t=" + to_string(threadOptions[t]);
+                bench_stats s = (threadOptions[t] == 1)
+                    ? bench.benchmarkSerial(name, data)
+                    : bench.benchmarkParallel(name, data, threadOptions[t], sparseFormats[f].threadFunc);
+                bench_registrar(config, &s);
+                result.times[f][t] = s.mediana;
+                
+                for (int r = 0; r < rows; r++) {
+                    result.maxDiff = max(result.maxDiff, fabs(data->getOutput()[r] - reference[r]));
+                }
+            }
         }
+        return result;
+    }
+    
+    void displaySparse(const vector<SparseCase>& cases, double density, int sigma) {
+        cout << "\n=== densa vs dispersa (densidad ~" << fixed << setprecision(1) << density * 100.0
+             << "%, C = " << SELL_C << ", sigma = " << sigma << ") ===" << endl;
+        for (const SparseCase& c : cases) {
+            cout << c.label << ": nnz = " << c.nnz << ", relleno SELL = " << setprecision(3) << c.fill
+                 << ", max |dif| = " << scientific << setprecision(2) << c.maxDiff << fixed << endl;
+        }
+        
+        cout << "|                                  |";
+        for (const SparseCase& c : cases) cout << " " << setw(13) << c.label << " |";
+        cout << endl;
+        cout << "|                                  |";
+        for (size_t i = 0; i < cases.size(); i++) cout << " Time    Spd.  |";
         cout << endl;
         
-        cout << "| 2                                |";
-        for (int i = 0; i < 3; i++) {
-            double eff = dummyBench.computeEfficiency(baseline[i], interleaved[i][1], 2);
-            cout << fixed << setprecision(3) << setw(6) << interleaved[i][1] << " " << setw(5) << eff << " |";
+        for (int f = 0; f < NUM_SPARSE_FORMATS; f++) {
+            cout << "|----------------------------------|";
+            for (size_t i = 0; i < cases.size(); i++) cout << "---------------|";
+            cout << endl;
+            for (int t = 0; t < 3; t++) {
+                string head = to_string(threadOptions[t]);
+                if (t == 0) head += string(" (") + sparseFormats[f].label + ")";
+                cout << "| " << left << setw(33) << head << right << "|";
+                for (const SparseCase& c : cases) {
+                    // speedup respecto de la densa serial (o de CSR serial sin densa)
+                    double base = (c.times[0][0] > 0.0) ? c.times[0][0] : c.times[1][0];
+                    if (c.times[f][t] < 0.0) {
+                        cout << setw(7) << "-" << " " << setw(5) << "-" << "  |";
+                    } else {
+                        cout << setprecision(4) << setw(7) << c.times[f][t] << " " << setprecision(2)
+                             << setw(5) << base / c.times[f][t] << "  |";
+                    }
+                }
+                cout << endl;
+            }
+        }
+        cout << "    ======" << endl;
+        cout << "Spd. = tiempo densa serial / tiempo (sin copia densa: CSR serial / tiempo)" << endl;
+    }
+    
+    // Y = A * X para k = 1..32 con la division por filas, serial y con el
+    // mayor numero de threads; tiempo por vector = tiempo / k
+    void runMultiVector() {
+        static const int NUM_K = 5;
+        int kOptions[NUM_K] = {1, 4, 8, 16, 32};
+        int threadsUsed[2] = {1, threadOptions[2]};
+        // X e Y crecen con k: los k que no entran en MATVEC_K_MB se saltean
+        double budgetMb = bench_entero_entorno("MATVEC_K_MB", 1024, 1);
+        double perVector[3][NUM_K][2];
+        double maxDiff[3];
+        
+        for (int tc = 0; tc < 3; tc++) {
+            cout << "procesando varios vectores " << testCases[tc].label << "..." << endl;
+            int rows = testCases[tc].rows, cols = testCases[tc].cols;
+            MatrixData* data = new MatrixData(rows, cols, &pool);
+            MatrixView mat = data->getView();
+            string caseName = to_string(rows) + "x" + to_string(cols);
+            maxDiff[tc] = 0.0;
+            
+            for (int ki = 0; ki < NUM_K; ki++) {
+                int k = kOptions[ki];
+                double mb = 8.0 * k * ((double)rows + cols) / (1024.0 * 1024.0);
+                if (mb > budgetMb) {
+                    perVector[tc][ki][0] = perVector[tc][ki][1] = -1.0;
+                    continue;
+                }
+                MultiVector mv = MultiVectorBenchmark::create(rows, cols, k);
+                for (int t = 0; t < 2; t++) {
+                    bench_stats st = MultiVectorBenchmark::run(
+                        config, "matvec_k/" + caseName + "/k=" + to_string(k) + "/t=" + to_string(threadsUsed[t]),
+                        &blockStrat, data, &mv, &pool, threadsUsed[t]);
+                    bench_registrar(config, &st);
+                    perVector[tc][ki][t] = st.mediana / k;
+                }
+                
+                // primera y ultima columna de Y contra el producto de un vector
+                vector<double> x(cols);
+                for (int j : {0, k - 1}) {
+                    for (int c = 0; c < cols; c++) x[c] = mv.X[(size_t)c * k + j];
+                    for (int r = 0; r < rows; r++) {
+                        double ref = rowDot(mat, r, x.data());
+                        maxDiff[tc] = max(maxDiff[tc], fabs(mv.Y[(size_t)r * k + j] - ref) / max(1.0, fabs(ref)));
+                    }
+                }
+                MultiVectorBenchmark::release(mv);
+            }
+            delete data;
+        }
+        
+        cout << "\n=== varios vectores: Y = A * X, X de cols x k (division por filas) ===" << endl;
+        cout << "|          |";
+        for (int tc = 0; tc < 3; tc++) cout << " " << setw(20) << testCases[tc].label << " |";
+        cout << endl;
+        cout << "| k  (t)   |";
+        for (int tc = 0; tc < 3; tc++) cout << "   t/vector   vs k=1  |";
+        cout << endl;
+        for (int ki = 0; ki < NUM_K; ki++) {
+            cout << "|----------|----------------------|----------------------|----------------------|" << endl;
+            for (int t = 0; t < 2; t++) {
+                string head = (t == 0 ? to_string(kOptions[ki]) : string("")) + " (" + to_string(threadsUsed[t]) + ")";
+                cout << "| " << left << setw(8) << head << right << " |";
+                for (int tc = 0; tc < 3; tc++) {
+                    double v = perVector[tc][ki][t];
+                    if (v < 0.0) {
+                        cout << setw(12) << "-" << setw(9) << "-" << " |";
+                    } else {
+                        cout << fixed << setprecision(6) << setw(12) << v << setprecision(2) << setw(8)
+                             << perVector[tc][0][t] / v << "x |";
+                    }
+                }
+                cout << endl;
+            }
+        }
+        cout << "    ======" << endl;
+        cout << "t/vector = segundos / k; vs k=1 = cuanto baja el tiempo por vector; - = X e Y no entran en "
+             << (int)budgetMb << " MB (MATVEC_K_MB)" << endl;
+        cout << "max |dif| contra el producto de a un vector:";
+        for (int tc = 0; tc < 3; tc++) {
+            cout << " " << scientific << setprecision(2) << maxDiff[tc] << fixed;
         }
         cout << endl;
+    }
+    
+    // Misma matriz guardada en double, float32, bfloat16 e int8 con escala,
+    // division por filas; error = max |y - y_double| / max |y_double|
+    void runPrecisionExperiments() {
+        double times[3][NUM_STORAGE_FORMATS][2];
+        double errors[3][NUM_STORAGE_FORMATS];
+        int threadsUsed[2] = {1, threadOptions[2]};
         
-        cout << "| 4                                |";
-        for (int i = 0; i < 3; i++) {
-            double eff = dummyBench.computeEfficiency(baseline[i], interleaved[i][2], 4);
-            cout << fixed << setprecision(3) << setw(6) << interleaved[i][2] << " " << setw(5) << eff << " |";
+        for (int tc = 0; tc < 3; tc++) {
+            cout << "procesando precision " << testCases[tc].label << "..." << endl;
+            int rows = testCases[tc].rows;
+            MatrixData* data = new MatrixData(rows, testCases[tc].cols, &pool);
+            string caseName = to_string(rows) + "x" + to_string(testCases[tc].cols);
+            
+            blockStrat.executeSerial(data);
+            vector<double> reference(data->getOutput(), data->getOutput() + rows);
+            double refMax = 0.0;
+            for (double v : reference) refMax = max(refMax, fabs(v));
+            
+            for (int f = 0; f < NUM_STORAGE_FORMATS; f++) {
+                StorageFormat format = (StorageFormat)f;
+                data->setStorage(format);
+                BenchmarkManager bench(&reducedStrat, config, &pool);
+                errors[tc][f] = 0.0;
+                for (int t = 0; t < 2; t++) {
+                    string name = string("matvec_prec/") + storageName(format) + "/" + caseName +
+                                  "/t=" + to_string(threadsUsed[t]);
+                    bench_stats st = (threadsUsed[t] == 1)
+                        ? bench.benchmarkSerial(name, data)
+                        : bench.benchmarkParallel(name, data, threadsUsed[t], reducedThreadFunc);
+                    bench_registrar(config, &st);
+                    times[tc][f][t] = st.mediana;
+                    
+                    for (int r = 0; r < rows; r++) {
+                        errors[tc][f] = max(errors[tc][f], fabs(data->getOutput()[r] - reference[r]));
+                    }
+                }
+                errors[tc][f] /= (refMax > 0.0 ? refMax : 1.0);
+            }
+            data->setStorage(STORAGE_F64);
+            delete data;
         }
+        
+        cout << "\n=== precision reducida: la matriz en menos bits, suma en double (division por filas) ===" << endl;
+        cout << "|                      |";
+        for (int tc = 0; tc < 3; tc++) cout << " " << setw(24) << testCases[tc].label << " |";
+        cout << endl;
+        cout << "| Formato (t)          |";
+        for (int tc = 0; tc < 3; tc++) cout << "  Time    Spd.   err.rel  |";
         cout << endl;
+        for (int f = 0; f < NUM_STORAGE_FORMATS; f++) {
+            cout << "|----------------------|--------------------------|--------------------------|--------------------------|" << endl;
+            for (int t = 0; t < 2; t++) {
+                string head = (t == 0 ? string(storageName((StorageFormat)f)) + ", " +
+                                        to_string(storageBytes((StorageFormat)f)) + " B " : string("")) +
+                              "(" + to_string(threadsUsed[t]) + ")";
+                cout << "| " << left << setw(20) << head << right << " |";
+                for (int tc = 0; tc < 3; tc++) {
+                    cout << fixed << setprecision(4) << setw(7) << times[tc][f][t] << " " << setprecision(2)
+                         << setw(5) << times[tc][STORAGE_F64][t] / times[tc][f][t] << " " << scientific
+                         << setprecision(2) << setw(10) << errors[tc][f] << fixed << " |";
+                }
+                cout << endl;
+            }
+        }
+        cout << "    ======" << endl;
+        cout << "Spd. = tiempo en double / tiempo con los mismos threads (mismo kernel de 4 acumuladores);" << endl;
+        cout << "err.rel = max |y - y_double| / max |y_double|, y_double de la division por filas" << endl;
+    }
+    
+    // x <- A x / ||A x|| con matrices cuadradas; las iteraciones bajan con n
+    // para que cada medicion recorra ~2^28 elementos (MATVEC_ITERACIONES es
+    // el maximo por medicion)
+    void runPowerIteration() {
+        static const int NUM_SIZES = 3;
+        int sizes[NUM_SIZES] = {256, 1024, 4096};
+        const char* barrierNames[2] = {"sentido", "arbol"};
+        int maxIterations = bench_entero_entorno("MATVEC_ITERACIONES", 1000, 1);
+        vector<string> lines;
+        double maxDiff = 0.0;
+        
+        for (int n : sizes) {
+            cout << "procesando iteracion de potencia " << n << " x " << n << "..." << endl;
+            MatrixData* data = new MatrixData(n, n, &pool);
+            int iterations = min(maxIterations, max(10, (int)((1L << 28) / ((long)n * n))));
+            vector<double> reference;
+            double referenceNorm = 0.0;
+            
+            for (int t = 0; t < 3; t++) {
+                int threads = threadOptions[t];
+                for (int b = 0; b < 2; b++) {
+                    string name = "matvec_potencia/" + to_string(n) + "x" + to_string(n) + "/" + barrierNames[b] +
+                                  "/t=" + to_string(threads);
+                    PowerResult last;
+                    bench_stats st = (b == 0)
+                        ? PowerIteration<SenseBarrier>::benchmark(config, name, &pool, data, threads, iterations, last)
+                        : PowerIteration<TreeBarrier>::benchmark(config, name, &pool, data, threads, iterations, last);
+                    bench_registrar(config, &st);
+                    
+                    if (t == 0 && b == 0) {
+                        reference = last.x;
+                        referenceNorm = last.norm;
+                    } else {
+                        maxDiff = max(maxDiff, fabs(last.norm - referenceNorm) / referenceNorm);
+                        for (int r = 0; r < n; r++) {
+                            maxDiff = max(maxDiff, fabs(last.x[r] - reference[r]) / referenceNorm);
+                        }
+                    }
+                    
+                    ostringstream line;
+                    line << "| " << left << setw(16)
+                         << (t == 0 && b == 0 ? to_string(n) + " (" + to_string(iterations) + ")" : "")
+                         << right << " | " << setw(7) << threads << " | " << left << setw(7) << barrierNames[b]
+                         << right << " | " << fixed << setprecision(2) << setw(10) << st.mediana / iterations * 1e6
+                         << " | " << setprecision(1) << setw(10) << 100.0 * last.kernel / last.seconds << " | "
+                         << setw(9) << 100.0 * last.waiting / last.seconds << " | " << setprecision(4) << setw(12)
+                         << last.norm << " |";
+                    lines.push_back(line.str());
+                }
+            }
+            delete data;
+        }
         
+        cout << "\n=== iteracion de potencia: x <- A x / ||A x||, workers persistentes ===" << endl;
+        cout << "| n (iteraciones)  | Threads | barrera | us/iter.   | producto % | barrera % | ||A x||      |" << endl;
+        for (size_t i = 0; i < lines.size(); i++) {
+            if (i % (3 * 2) == 0) {
+                cout << "|------------------|---------|---------|------------|------------|-----------|--------------|" << endl;
+            }
+            cout << lines[i] << endl;
+        }
         cout << "    ======" << endl;
+        cout << "us/iter. = mediana de la region completa / iteraciones; producto % y barrera % = tiempo promedio" << endl;
+        cout << "por thread en el producto de sus filas (con su parcial de la norma) y esperando en la barrera," << endl;
+        cout << "sobre la region de la ultima repeticion; sentido = SenseBarrier, arbol = TreeBarrier" << endl;
+        cout << "max |dif| relativa de x y ||A x|| contra 1 thread: " << scientific << setprecision(2) << maxDiff
+             << fixed << endl;
+    }
+    
+    void runLayoutComparison() {
+        double times[3][4];
+        for (int tc = 0; tc < 3; tc++) {
+            cout << "procesando layout " << testCases[tc].label << "..." << endl;
+            LayoutBenchmark::run(config, testCases[tc].rows, testCases[tc].cols,
+                                 to_string(testCases[tc].rows) + "x" + to_string(testCases[tc].cols), times[tc]);
+        }
+        
+        cout << "\n=== layout: new[] por fila vs bloque alineado con stride (serial) ===" << endl;
+        cout << "| Dimension      | Construir filas  bloque  mejora | Kernel filas  bloque  mejora |" << endl;
+        cout << "|----------------|---------------------------------|------------------------------|" << endl;
+        for (int tc = 0; tc < 3; tc++) {
+            cout << "| " << left << setw(14) << testCases[tc].label << right << " |" << fixed
+                 << setprecision(4) << setw(16) << times[tc][0] << setw(8) << times[tc][1]
+                 << setprecision(2) << setw(7) << times[tc][0] / times[tc][1] << "x |"
+                 << setprecision(4) << setw(13) << times[tc][2] << setw(8) << times[tc][3]
+                 << setprecision(2) << setw(7) << times[tc][2] / times[tc][3] << "x |" << endl;
+        }
+        cout << "construir = reservar + escribir cada elemento; kernel = producto serial" << endl;
     }
     
     void displayFooter() {
-        cout << "\ntiempos en segundos" << endl;
+        cout << "\ntiempos en segundos (mediana de " << config->repeticiones << " repeticiones, "
+             << config->calentamiento << " de calentamiento)" << endl;
         cout << "eficiencia = tiempo_serial / (tiempo_paralelo * num_threads)" << endl;
         cout << "dimensiones probadas: 8,000,000 x 8, 8000 x 8000, 8 x 8,000,000" << endl;
         
         cout << "\n=== analisis de rendimiento ===" << endl;
         cout << "- division por filas: cada thread procesa un bloque continuo de filas" << endl;
         cout << "- division ciclica: cada thread procesa filas alternadas (mejor balance de carga)" << endl;
+        cout << "- bloque-ciclica: bloques de " << blockCyclicStrat.getChunkLines()
+             << " lineas de cache de y en ronda (MATVEC_BLOQUE_LINEAS): balance de la ciclica sin compartir lineas" << endl;
+        cout << "- dinamica / guiada: los threads piden rangos a un contador atomico (fijo del mismo tamano que" << endl;
+        cout << "  la bloque-ciclica, o lo que falta / 2t); un thread demorado no retiene filas de antemano" << endl;
+        cout << "- cada fila se acumula en un registro; y se escribe una vez por fila, no por columna" << endl;
+        cout << "- por columnas: cada thread una franja de x y un y parcial, sumados en arbol (8 x 8,000,000)" << endl;
+        cout << "- tiles 2D: la grilla minimiza filas/franja + columnas/franja; reduce solo si parte columnas" << endl;
+        cout << "- varios vectores: cada elemento de A se usa para k FMA; por vector el tiempo baja hasta" << endl;
+        cout << "  que el producto deja de estar limitado por memoria" << endl;
+        cout << "- precision reducida: float32 / bfloat16 / int8 leen 4 / 2 / 1 byte por elemento en vez de 8;" << endl;
+        cout << "  conviene el formato mas chico cuyo err.rel entre en la tolerancia" << endl;
+        cout << "- iteracion de potencia: los workers no salen entre iteraciones y se cruzan una sola barrera" << endl;
+        cout << "  por iteracion; con n chico la barrera pesa tanto como el producto" << endl;
+        cout << "- NUMA: LAB04_AFINIDAD=compacta|dispersa|lista de cpus fija los workers; con primer toque" << endl;
+        cout << "  cada estrategia copia la matriz desde sus workers antes de medir, y sus paginas quedan" << endl;
+        cout << "  en el nodo del thread que las lee" << endl;
+        cout << "- datos: Philox por contador, los workers llenan sus filas en paralelo y la corrida se" << endl;
+        cout << "  repite bit a bit con la misma LAB04_SEMILLA, con cualquier cantidad de threads" << endl;
         cout << "- eficiencia ideal = 1.0 (speedup lineal)" << endl;
         cout << "- matrices anchas (pocas filas) escalan peor" << endl;
         cout << "- matrices altas (muchas filas) escalan mejor" << endl;
+        cout << "- dispersa: CSR/SELL solo leen los no ceros; repartir por nnz compensa filas desparejas" << endl;
+        cout << "  (SPMV_DENSIDAD=% de no ceros, SPMV_SIGMA=ventana de orden, SPMV_MTX=archivo .mtx)" << endl;
     }
 };
 
 //   Función principal  
-int main(int argc, char* argv[]) {
+int main(int argc, char**) {
     if (argc != 1) {
         return 1;
     }
     
-    ResultPresenter presenter;
+    bench_config cfg = bench_config_entorno();
+    ResultPresenter presenter(&cfg);
     presenter.displayHeader();
     presenter.runExperiments();
+    presenter.runMultiVector();
+    presenter.runPrecisionExperiments();
+    presenter.runPowerIteration();
+    presenter.runLayoutComparison();
+    presenter.runSparseExperiments();
     presenter.displayFooter();
+    bench_config_cerrar(&cfg);
     
     return 0;
 }
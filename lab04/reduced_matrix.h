@@ -0,0 +1,278 @@
+#ifndef REDUCED_MATRIX_H
+#define REDUCED_MATRIX_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Copia de una matriz densa en menos bits por elemento para y = A * x. El
+// producto esta limitado por ancho de banda, asi que leer 4, 2 o 1 byte por
+// elemento en vez de 8 baja el trafico; la suma se sigue haciendo en double.
+//
+// - float32: 4 bytes, ~7 digitos.
+// - bfloat16: los 16 bits altos de un float (mismo rango, 8 bits de
+//   mantisa), redondeado al par mas cercano; 2 bytes.
+// - int8 con escala por fila: q = round(a / s) con s = max|fila| / 127; la
+//   fila se reconstruye como s * q. 1 byte mas un double por fila.
+//
+// Los kernels convierten al cargar: cada carga lee 4 elementos, los pasa a
+// double en registros (cvtps2pd, bf16 corrido 16 bits, int8 extendido con
+// signo) y suma en REDUCED_UNROLL acumuladores independientes, asi la suma
+// no queda esperando la latencia de un solo acumulador. Con AVX2 + FMA un
+// grupo de 4 es un ymm; con SSE2 (lo minimo en x86-64) son dos xmm; en otras
+// arquitecturas, escalar.
+
+enum StorageFormat {
+    STORAGE_F64,
+    STORAGE_F32,
+    STORAGE_BF16,
+    STORAGE_I8
+};
+
+static const int NUM_STORAGE_FORMATS = 4;
+
+static inline const char* storageName(StorageFormat f) {
+    switch (f) {
+        case STORAGE_F64:  return "double";
+        case STORAGE_F32:  return "float32";
+        case STORAGE_BF16: return "bfloat16";
+        case STORAGE_I8:   return "int8+escala";
+    }
+    return "?";
+}
+
+static inline size_t storageBytes(StorageFormat f) {
+    switch (f) {
+        case STORAGE_F64:  return 8;
+        case STORAGE_F32:  return 4;
+        case STORAGE_BF16: return 2;
+        case STORAGE_I8:   return 1;
+    }
+    return 8;
+}
+
+// float -> bfloat16 redondeando al par mas cercano (NaN queda NaN)
+static inline uint16_t floatToBf16(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    if ((bits & 0x7fffffffu) > 0x7f800000u) return (uint16_t)((bits >> 16) | 0x40);
+    bits += 0x7fffu + ((bits >> 16) & 1u);
+    return (uint16_t)(bits >> 16);
+}
+
+static inline float bf16ToFloat(uint16_t h) {
+    uint32_t bits = (uint32_t)h << 16;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+// Un elemento guardado -> double (la cola de cada fila); uint16_t es bf16
+static inline double reducedScalar(double a) { return a; }
+static inline double reducedScalar(float a) { return a; }
+static inline double reducedScalar(uint16_t a) { return bf16ToFloat(a); }
+static inline double reducedScalar(int8_t a) { return a; }
+
+static const int REDUCED_UNROLL = 4;
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+struct ReducedQuad {
+    __m256d v;
+};
+
+static inline ReducedQuad reducedZero() { return {_mm256_setzero_pd()}; }
+
+static inline ReducedQuad reducedLoad(const double* p) { return {_mm256_loadu_pd(p)}; }
+
+static inline ReducedQuad reducedLoad(const float* p) { return {_mm256_cvtps_pd(_mm_loadu_ps(p))}; }
+
+static inline ReducedQuad reducedLoad(const uint16_t* p) {
+    __m128i h = _mm_loadl_epi64((const __m128i*)p);
+    return {_mm256_cvtps_pd(_mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), h)))};
+}
+
+static inline ReducedQuad reducedLoad(const int8_t* p) {
+    int32_t w;
+    memcpy(&w, p, sizeof(w));
+    return {_mm256_cvtepi32_pd(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(w)))};
+}
+
+static inline ReducedQuad reducedFma(ReducedQuad acc, ReducedQuad a, const double* x) {
+    return {_mm256_fmadd_pd(a.v, _mm256_loadu_pd(x), acc.v)};
+}
+
+static inline double reducedSum(ReducedQuad a) {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(a.v), _mm256_extractf128_pd(a.v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+#elif defined(__SSE2__)
+
+struct ReducedQuad {
+    __m128d lo, hi;
+};
+
+static inline ReducedQuad reducedZero() { return {_mm_setzero_pd(), _mm_setzero_pd()}; }
+
+static inline ReducedQuad reducedLoad(const double* p) { return {_mm_loadu_pd(p), _mm_loadu_pd(p + 2)}; }
+
+static inline ReducedQuad reducedLoad(const float* p) {
+    __m128 a = _mm_loadu_ps(p);
+    return {_mm_cvtps_pd(a), _mm_cvtps_pd(_mm_movehl_ps(a, a))};
+}
+
+static inline ReducedQuad reducedLoad(const uint16_t* p) {
+    __m128i h = _mm_loadl_epi64((const __m128i*)p);
+    __m128 a = _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), h));
+    return {_mm_cvtps_pd(a), _mm_cvtps_pd(_mm_movehl_ps(a, a))};
+}
+
+static inline ReducedQuad reducedLoad(const int8_t* p) {
+    int32_t w;
+    memcpy(&w, p, sizeof(w));
+    // cada byte queda en el byte alto de un int32 y se corre con signo
+    __m128i b = _mm_cvtsi32_si128(w);
+    b = _mm_unpacklo_epi8(b, b);
+    __m128i i = _mm_srai_epi32(_mm_unpacklo_epi16(b, b), 24);
+    return {_mm_cvtepi32_pd(i), _mm_cvtepi32_pd(_mm_shuffle_epi32(i, 0xee))};
+}
+
+static inline ReducedQuad reducedFma(ReducedQuad acc, ReducedQuad a, const double* x) {
+    return {_mm_add_pd(acc.lo, _mm_mul_pd(a.lo, _mm_loadu_pd(x))),
+            _mm_add_pd(acc.hi, _mm_mul_pd(a.hi, _mm_loadu_pd(x + 2)))};
+}
+
+static inline double reducedSum(ReducedQuad a) {
+    __m128d s = _mm_add_pd(a.lo, a.hi);
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+#else
+
+struct ReducedQuad {
+    double v[4];
+};
+
+static inline ReducedQuad reducedZero() { return {{0.0, 0.0, 0.0, 0.0}}; }
+
+template <class T>
+static inline ReducedQuad reducedLoad(const T* p) {
+    ReducedQuad q;
+    for (int l = 0; l < 4; l++) q.v[l] = reducedScalar(p[l]);
+    return q;
+}
+
+static inline ReducedQuad reducedFma(ReducedQuad acc, ReducedQuad a, const double* x) {
+    for (int l = 0; l < 4; l++) acc.v[l] += a.v[l] * x[l];
+    return acc;
+}
+
+static inline double reducedSum(ReducedQuad a) { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+
+#endif
+
+// sum(row[c] * x[c]) con la fila en cualquiera de los formatos
+template <class T>
+static inline double reducedDot(const T* row, const double* x, int cols) {
+    ReducedQuad acc[REDUCED_UNROLL];
+    for (int u = 0; u < REDUCED_UNROLL; u++) acc[u] = reducedZero();
+    const int step = 4 * REDUCED_UNROLL;
+    int c = 0;
+    for (; c + step <= cols; c += step) {
+        for (int u = 0; u < REDUCED_UNROLL; u++) {
+            acc[u] = reducedFma(acc[u], reducedLoad(row + c + 4 * u), x + c + 4 * u);
+        }
+    }
+    double sum = 0.0;
+    for (int u = 0; u < REDUCED_UNROLL; u++) sum += reducedSum(acc[u]);
+    for (; c < cols; c++) sum += reducedScalar(row[c]) * x[c];
+    return sum;
+}
+
+struct ReducedMatrix {
+    StorageFormat format = STORAGE_F32;
+    int rows = 0;
+    int cols = 0;
+    size_t stride = 0;           // elementos entre filas (filas alineadas a 64 bytes)
+    void* data = nullptr;
+    std::vector<double> scale;   // solo int8: escala de cada fila
+
+    ReducedMatrix() {}
+    ReducedMatrix(const ReducedMatrix&) = delete;
+    ReducedMatrix& operator=(const ReducedMatrix&) = delete;
+    ~ReducedMatrix() { free(data); }
+
+    size_t bytes() const { return (size_t)rows * stride * storageBytes(format) + scale.size() * sizeof(double); }
+
+    // Densa row-major con 'srcStride' doubles entre filas; STORAGE_F64 no
+    // tiene copia reducida (se usa la densa tal cual)
+    bool fromDense(StorageFormat f, const double* mat, size_t srcStride, int r, int c) {
+        if (f == STORAGE_F64) return false;
+        free(data);
+        format = f;
+        rows = r;
+        cols = c;
+        size_t perLine = 64 / storageBytes(f);
+        stride = ((size_t)cols + perLine - 1) / perLine * perLine;
+        size_t total = (size_t)rows * stride * storageBytes(f);
+        data = aligned_alloc(64, (total + 63) / 64 * 64);
+        if (data == nullptr) return false;
+        memset(data, 0, total);
+        scale.assign(f == STORAGE_I8 ? rows : 0, 1.0);
+
+        for (int i = 0; i < rows; i++) {
+            const double* src = mat + (size_t)i * srcStride;
+            if (f == STORAGE_F32) {
+                float* dst = (float*)data + (size_t)i * stride;
+                for (int j = 0; j < cols; j++) dst[j] = (float)src[j];
+            } else if (f == STORAGE_BF16) {
+                uint16_t* dst = (uint16_t*)data + (size_t)i * stride;
+                for (int j = 0; j < cols; j++) dst[j] = floatToBf16((float)src[j]);
+            } else {
+                int8_t* dst = (int8_t*)data + (size_t)i * stride;
+                double maxAbs = 0.0;
+                for (int j = 0; j < cols; j++) maxAbs = std::max(maxAbs, std::fabs(src[j]));
+                double s = (maxAbs > 0.0) ? maxAbs / 127.0 : 1.0;
+                scale[i] = s;
+                for (int j = 0; j < cols; j++) {
+                    long q = std::lround(src[j] / s);
+                    dst[j] = (int8_t)std::max(-127L, std::min(127L, q));
+                }
+            }
+        }
+        return true;
+    }
+
+    // y[begin, end) con la conversion elegida fuera del bucle de filas
+    void multiplyRows(int begin, int end, const double* x, double* y) const {
+        switch (format) {
+            case STORAGE_BF16:
+                for (int r = begin; r < end; r++) {
+                    y[r] = reducedDot((const uint16_t*)data + (size_t)r * stride, x, cols);
+                }
+                break;
+            case STORAGE_I8:
+                for (int r = begin; r < end; r++) {
+                    y[r] = reducedDot((const int8_t*)data + (size_t)r * stride, x, cols) * scale[r];
+                }
+                break;
+            default:
+                for (int r = begin; r < end; r++) {
+                    y[r] = reducedDot((const float*)data + (size_t)r * stride, x, cols);
+                }
+                break;
+        }
+    }
+
+};
+
+#endif
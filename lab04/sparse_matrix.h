@@ -0,0 +1,264 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Formatos dispersos para y = A * x.
+//
+// CSR: las filas una detras de otra, rowPtr[r]..rowPtr[r+1] indexa colIdx y
+// values. Solo se recorren los no ceros, pero el bucle interno tiene largo
+// variable y x se lee indirecto.
+//
+// SELL-C-sigma: las filas se ordenan por largo dentro de ventanas de sigma
+// filas y se agrupan de a C (un chunk). Cada chunk se guarda por columnas y
+// rellenado hasta su fila mas larga, asi las C filas avanzan juntas en un
+// vector SIMD. Ordenar solo dentro de la ventana deja el acceso a y casi
+// secuencial y el relleno bajo.
+//
+// Para repartir entre threads ambos formatos dan un corte por no ceros
+// (balancedRow / balancedChunk) en vez de por cantidad de filas.
+
+static const int SELL_C = 8;   // filas por chunk = doubles en un vector de 64 bytes
+
+struct CsrMatrix {
+    int rows = 0;
+    int cols = 0;
+    std::vector<long> rowPtr;
+    std::vector<int> colIdx;
+    std::vector<double> values;
+
+    long nnz() const { return rowPtr.empty() ? 0 : rowPtr[rows]; }
+
+    // Densa row-major con 'stride' doubles entre filas
+    void fromDense(const double* mat, size_t stride, int r, int c) {
+        rows = r;
+        cols = c;
+        rowPtr.assign(rows + 1, 0);
+        colIdx.clear();
+        values.clear();
+        for (int i = 0; i < rows; i++) {
+            const double* row = mat + (size_t)i * stride;
+            for (int j = 0; j < cols; j++) {
+                if (row[j] != 0.0) {
+                    colIdx.push_back(j);
+                    values.push_back(row[j]);
+                }
+            }
+            rowPtr[i + 1] = (long)values.size();
+        }
+    }
+
+    // Lee un archivo Matrix Market "coordinate" (real, integer o pattern;
+    // general, symmetric o skew-symmetric). Los duplicados se suman.
+    bool loadMatrixMarket(const char* path, std::string& error) {
+        FILE* f = fopen(path, "r");
+        if (f == nullptr) {
+            error = std::string("no se pudo abrir ") + path;
+            return false;
+        }
+
+        char line[1024];
+        char object[64], format[64], field[64], symmetry[64];
+        if (fgets(line, sizeof(line), f) == nullptr ||
+            sscanf(line, "%%%%MatrixMarket %63s %63s %63s %63s", object, format, field, symmetry) != 4) {
+            fclose(f);
+            error = "falta la cabecera %%MatrixMarket";
+            return false;
+        }
+        bool pattern = strcmp(field, "pattern") == 0;
+        bool symmetric = strcmp(symmetry, "symmetric") == 0;
+        bool skew = strcmp(symmetry, "skew-symmetric") == 0;
+        if (strcmp(object, "matrix") != 0 || strcmp(format, "coordinate") != 0 ||
+            (!pattern && strcmp(field, "real") != 0 && strcmp(field, "integer") != 0) ||
+            (!symmetric && !skew && strcmp(symmetry, "general") != 0)) {
+            fclose(f);
+            error = std::string("formato no soportado: ") + object + " " + format + " " + field + " " + symmetry;
+            return false;
+        }
+
+        long entries = -1;
+        while (fgets(line, sizeof(line), f) != nullptr) {
+            if (line[0] == '%') continue;
+            if (sscanf(line, "%d %d %ld", &rows, &cols, &entries) == 3) break;
+        }
+        if (entries < 0 || rows <= 0 || cols <= 0) {
+            fclose(f);
+            error = "linea de tamaño invalida";
+            return false;
+        }
+
+        // coordenadas (0-based) en el orden del archivo; las simetricas se espejan
+        std::vector<int> ri, ci;
+        std::vector<double> vi;
+        ri.reserve(entries);
+        ci.reserve(entries);
+        vi.reserve(entries);
+        for (long e = 0; e < entries; e++) {
+            int i, j;
+            double v = 1.0;
+            int read = pattern ? fscanf(f, "%d %d", &i, &j) : fscanf(f, "%d %d %lf", &i, &j, &v);
+            if (read != (pattern ? 2 : 3) || i < 1 || i > rows || j < 1 || j > cols) {
+                fclose(f);
+                error = "entrada " + std::to_string(e + 1) + " invalida";
+                return false;
+            }
+            ri.push_back(i - 1);
+            ci.push_back(j - 1);
+            vi.push_back(v);
+            if ((symmetric || skew) && i != j) {
+                ri.push_back(j - 1);
+                ci.push_back(i - 1);
+                vi.push_back(skew ? -v : v);
+            }
+        }
+        fclose(f);
+
+        // counting sort por fila, despues columnas ordenadas y duplicados sumados
+        rowPtr.assign(rows + 1, 0);
+        for (int r : ri) rowPtr[r + 1]++;
+        for (int r = 0; r < rows; r++) rowPtr[r + 1] += rowPtr[r];
+        std::vector<long> next(rowPtr.begin(), rowPtr.end() - 1);
+        std::vector<std::pair<int, double>> sorted(ri.size());
+        for (size_t e = 0; e < ri.size(); e++) {
+            sorted[next[ri[e]]++] = std::make_pair(ci[e], vi[e]);
+        }
+
+        colIdx.clear();
+        values.clear();
+        long start = 0;
+        for (int r = 0; r < rows; r++) {
+            long end = rowPtr[r + 1];
+            std::sort(sorted.begin() + start, sorted.begin() + end,
+                      [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+                          return a.first < b.first;
+                      });
+            for (long p = start; p < end; p++) {
+                if (!colIdx.empty() && p > start && colIdx.back() == sorted[p].first) {
+                    values.back() += sorted[p].second;
+                } else {
+                    colIdx.push_back(sorted[p].first);
+                    values.push_back(sorted[p].second);
+                }
+            }
+            start = end;
+            rowPtr[r + 1] = (long)values.size();
+        }
+        return true;
+    }
+
+    void multiplyRows(int begin, int end, const double* x, double* y) const {
+        const long* ptr = rowPtr.data();
+        const int* col = colIdx.data();
+        const double* val = values.data();
+        for (int r = begin; r < end; r++) {
+            double sum = 0.0;
+            for (long p = ptr[r]; p < ptr[r + 1]; p++) {
+                sum += val[p] * x[col[p]];
+            }
+            y[r] = sum;
+        }
+    }
+
+    // Primera fila de la parte 'part' de 'parts' con igual cantidad de no ceros
+    int balancedRow(int part, int parts) const {
+        if (part <= 0) return 0;
+        if (part >= parts) return rows;
+        long target = nnz() * part / parts;
+        return (int)(std::lower_bound(rowPtr.begin(), rowPtr.end(), target) - rowPtr.begin());
+    }
+};
+
+struct SellMatrix {
+    int rows = 0;
+    int cols = 0;
+    int sigma = 0;
+    int numChunks = 0;
+    std::vector<int> perm;       // posicion ordenada -> fila original (-1 = relleno)
+    std::vector<long> chunkPtr;  // inicio de cada chunk en colIdx / values
+    std::vector<int> chunkLen;   // largo de la fila mas larga del chunk
+    std::vector<int> colIdx;     // chunk k, columna j, fila l: chunkPtr[k] + j * SELL_C + l
+    std::vector<double> values;
+
+    void fromCsr(const CsrMatrix& a, int windowRows) {
+        rows = a.rows;
+        cols = a.cols;
+        sigma = std::max(windowRows, SELL_C);
+        numChunks = (rows + SELL_C - 1) / SELL_C;
+
+        perm.assign((size_t)numChunks * SELL_C, -1);
+        for (int r = 0; r < rows; r++) perm[r] = r;
+        for (int w = 0; w < rows; w += sigma) {
+            int end = std::min(w + sigma, rows);
+            std::stable_sort(perm.begin() + w, perm.begin() + end, [&a](int x, int y) {
+                return a.rowPtr[x + 1] - a.rowPtr[x] > a.rowPtr[y + 1] - a.rowPtr[y];
+            });
+        }
+
+        chunkPtr.assign(numChunks + 1, 0);
+        chunkLen.assign(numChunks, 0);
+        for (int k = 0; k < numChunks; k++) {
+            int len = 0;
+            for (int l = 0; l < SELL_C; l++) {
+                int r = perm[k * SELL_C + l];
+                if (r >= 0) len = std::max(len, (int)(a.rowPtr[r + 1] - a.rowPtr[r]));
+            }
+            chunkLen[k] = len;
+            chunkPtr[k + 1] = chunkPtr[k] + (long)len * SELL_C;
+        }
+
+        // relleno: columna 0 con valor 0, no cambia la suma
+        colIdx.assign(chunkPtr[numChunks], 0);
+        values.assign(chunkPtr[numChunks], 0.0);
+        for (int k = 0; k < numChunks; k++) {
+            for (int l = 0; l < SELL_C; l++) {
+                int r = perm[k * SELL_C + l];
+                if (r < 0) continue;
+                long base = a.rowPtr[r];
+                int len = (int)(a.rowPtr[r + 1] - base);
+                for (int j = 0; j < len; j++) {
+                    colIdx[chunkPtr[k] + (long)j * SELL_C + l] = a.colIdx[base + j];
+                    values[chunkPtr[k] + (long)j * SELL_C + l] = a.values[base + j];
+                }
+            }
+        }
+    }
+
+    void multiplyChunks(int begin, int end, const double* x, double* y) const {
+        const int* col = colIdx.data();
+        const double* val = values.data();
+        for (int k = begin; k < end; k++) {
+            double acc[SELL_C] = {0.0};
+            long base = chunkPtr[k];
+            for (int j = 0; j < chunkLen[k]; j++) {
+                const int* c = col + base + (long)j * SELL_C;
+                const double* v = val + base + (long)j * SELL_C;
+                for (int l = 0; l < SELL_C; l++) {
+                    acc[l] += v[l] * x[c[l]];
+                }
+            }
+            for (int l = 0; l < SELL_C; l++) {
+                int r = perm[k * SELL_C + l];
+                if (r >= 0) y[r] = acc[l];
+            }
+        }
+    }
+
+    // Primer chunk de la parte 'part' de 'parts' con igual almacenamiento
+    int balancedChunk(int part, int parts) const {
+        if (part <= 0) return 0;
+        if (part >= parts) return numChunks;
+        long target = chunkPtr[numChunks] * part / parts;
+        return (int)(std::lower_bound(chunkPtr.begin(), chunkPtr.end(), target) - chunkPtr.begin());
+    }
+
+    // Elementos guardados (con relleno) por cada no cero real
+    double fillRatio(long nnz) const {
+        return nnz > 0 ? (double)chunkPtr[numChunks] / nnz : 1.0;
+    }
+};
+
+#endif
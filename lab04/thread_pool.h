@@ -0,0 +1,402 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "../comun/benchmark.h"
+#include "affinity.h"
+
+// Pool de workers persistentes para los programas de lab04.
+//
+// Los threads se crean una vez y quedan estacionados en una variable de
+// condicion hasta que llega trabajo, como en produccion donde los threads
+// viven todo el proceso. Crear y unir pthreads en cada medicion cuesta
+// decenas de microsegundos por thread, que en casos cortos (8 x 8,000,000)
+// es una parte visible del tiempo.
+//
+// - submit(fn, arg): la toma cualquier worker libre.
+// - submitTo(w, fn, arg): la ejecuta el worker w, con 0 <= w < size() (para
+//   tareas que necesitan correr todas a la vez, p.ej. las que se pasan el
+//   turno con semaforos).
+// - ambas devuelven un TaskFuture; get() espera y devuelve lo que devolvio fn.
+// - pinWorker(w, cpu): fija el worker w a una CPU (Affinity::pinPool).
+// - runParallel(count, fn, args): fn(args[i]) en los workers 0..count-1 a la
+//   vez, arrancando juntos desde una barrera; devuelve los segundos desde el
+//   primer worker que sale de la barrera hasta el ultimo que termina, asi que
+//   el despertar de los workers no entra en la medicion.
+// - lastRegionSpan() / lastRegionBusy(i): ese tiempo y los segundos que el
+//   worker i estuvo dentro de fn en el ultimo runParallel; la diferencia es
+//   lo que espero a los demas.
+
+typedef void* (*PoolTask)(void*);
+
+//   Barrera con inversion de sentido: el ultimo en llegar reinicia el contador
+//   e invierte el sentido global; los demas esperan a ver el sentido nuevo.
+//   Espera activa acotada y despues sched_yield(), porque puede haber mas
+//   threads que nucleos.
+class SenseBarrier {
+private:
+    struct alignas(64) LocalSense {
+        bool sense;
+    };
+
+    alignas(64) std::atomic<int> remaining;
+    alignas(64) std::atomic<bool> globalSense;
+    int parties;
+    std::vector<LocalSense> local;
+
+public:
+    static const int SPIN_LIMIT = 1000;
+
+    SenseBarrier(int n = 1) : remaining(n), globalSense(false), parties(n), local(n) {
+        for (int i = 0; i < n; i++) local[i].sense = false;
+    }
+
+    // Solo con nadie esperando en la barrera
+    void reset(int n) {
+        parties = n;
+        local.resize(n);
+        bool current = globalSense.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; i++) local[i].sense = current;
+        remaining.store(n, std::memory_order_relaxed);
+    }
+
+    int size() const { return parties; }
+
+    void wait(int id) {
+        bool mySense = !local[id].sense;
+        local[id].sense = mySense;
+        if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            remaining.store(parties, std::memory_order_relaxed);
+            globalSense.store(mySense, std::memory_order_release);
+            return;
+        }
+        int spins = 0;
+        while (globalSense.load(std::memory_order_acquire) != mySense) {
+            if (++spins > SPIN_LIMIT) {
+                sched_yield();
+            }
+        }
+    }
+};
+
+//   Barrera en arbol de combinacion: los threads llegan de a FAN_IN a un nodo
+//   hoja, el ultimo de cada nodo sigue hacia el padre y el ultimo de la raiz
+//   invierte el sentido global. Cada contador lo tocan a lo sumo FAN_IN
+//   threads, en vez de todos sobre el mismo como en SenseBarrier; la salida
+//   sigue siendo un solo flag que todos leen. Misma espera que SenseBarrier.
+class TreeBarrier {
+private:
+    static const int FAN_IN = 4;
+
+    struct alignas(64) Node {
+        std::atomic<int> remaining;
+        int parties;
+        int parent;     // -1 en la raiz
+    };
+
+    struct alignas(64) LocalSense {
+        bool sense;
+    };
+
+    std::unique_ptr<Node[]> nodes;
+    int parties;
+    alignas(64) std::atomic<bool> globalSense;
+    std::vector<LocalSense> local;
+
+    // nodos de cada nivel: de a FAN_IN hijos por padre, hasta uno solo
+    void build(int n) {
+        std::vector<int> levelSize;
+        for (int width = n; ; width = (width + FAN_IN - 1) / FAN_IN) {
+            levelSize.push_back((width + FAN_IN - 1) / FAN_IN);
+            if (levelSize.back() == 1) break;
+        }
+        int total = 0;
+        for (int size : levelSize) total += size;
+        nodes.reset(new Node[total]);
+
+        int first = 0, below = n;
+        for (size_t level = 0; level < levelSize.size(); level++) {
+            int size = levelSize[level];
+            for (int k = 0; k < size; k++) {
+                Node& node = nodes[first + k];
+                node.parties = std::min(FAN_IN, below - k * FAN_IN);
+                node.remaining.store(node.parties, std::memory_order_relaxed);
+                node.parent = (level + 1 < levelSize.size()) ? first + size + k / FAN_IN : -1;
+            }
+            first += size;
+            below = size;
+        }
+    }
+
+    void arrive(int node, bool sense) {
+        while (true) {
+            Node& n = nodes[node];
+            if (n.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+            // nadie vuelve a este nodo hasta que cambie el sentido global
+            n.remaining.store(n.parties, std::memory_order_relaxed);
+            if (n.parent < 0) {
+                globalSense.store(sense, std::memory_order_release);
+                return;
+            }
+            node = n.parent;
+        }
+    }
+
+public:
+    TreeBarrier(int n = 1) : parties(0), globalSense(false) {
+        reset(n);
+    }
+
+    // Solo con nadie esperando en la barrera
+    void reset(int n) {
+        parties = n;
+        build(n);
+        local.resize(n);
+        bool current = globalSense.load(std::memory_order_relaxed);
+        for (int i = 0; i < n; i++) local[i].sense = current;
+    }
+
+    int size() const { return parties; }
+
+    void wait(int id) {
+        bool mySense = !local[id].sense;
+        local[id].sense = mySense;
+        arrive(id / FAN_IN, mySense);
+        int spins = 0;
+        while (globalSense.load(std::memory_order_acquire) != mySense) {
+            if (++spins > SenseBarrier::SPIN_LIMIT) {
+                sched_yield();
+            }
+        }
+    }
+};
+
+//   Estado compartido entre quien envia una tarea y el worker que la corre
+struct TaskState {
+    pthread_mutex_t lock;
+    pthread_cond_t finished;
+    bool done;
+    void* result;
+
+    TaskState() : done(false), result(nullptr) {
+        pthread_mutex_init(&lock, nullptr);
+        pthread_cond_init(&finished, nullptr);
+    }
+
+    ~TaskState() {
+        pthread_cond_destroy(&finished);
+        pthread_mutex_destroy(&lock);
+    }
+
+    void complete(void* value) {
+        pthread_mutex_lock(&lock);
+        result = value;
+        done = true;
+        pthread_cond_broadcast(&finished);
+        pthread_mutex_unlock(&lock);
+    }
+};
+
+class TaskFuture {
+private:
+    std::shared_ptr<TaskState> state;
+
+public:
+    TaskFuture() {}
+    TaskFuture(std::shared_ptr<TaskState> s) : state(s) {}
+
+    bool ready() {
+        pthread_mutex_lock(&state->lock);
+        bool d = state->done;
+        pthread_mutex_unlock(&state->lock);
+        return d;
+    }
+
+    void* get() {
+        pthread_mutex_lock(&state->lock);
+        while (!state->done) {
+            pthread_cond_wait(&state->finished, &state->lock);
+        }
+        void* r = state->result;
+        pthread_mutex_unlock(&state->lock);
+        return r;
+    }
+};
+
+class ThreadPool {
+private:
+    struct Task {
+        PoolTask fn;
+        void* arg;
+        std::shared_ptr<TaskState> state;
+    };
+
+    struct WorkerArg {
+        ThreadPool* pool;
+        int id;
+    };
+
+    // Tarea de runParallel: una por worker participante
+    struct RegionSlot {
+        ThreadPool* pool;
+        int id;
+        PoolTask fn;
+        void* arg;
+        void* result;
+        double start;
+        double finish;
+    };
+
+    int numWorkers;
+    std::vector<pthread_t> threads;
+    std::vector<WorkerArg> args;
+    std::deque<Task> shared;
+    std::vector<std::deque<Task>> pinned;   // cola propia de cada worker (submitTo)
+
+    pthread_mutex_t stateLock;
+    pthread_cond_t workReady;
+    bool shuttingDown;
+
+    SenseBarrier barrier;
+
+    double regionSpan;
+    std::vector<double> regionBusy;
+
+    static void* workerEntry(void* arg) {
+        WorkerArg* wa = (WorkerArg*)arg;
+        wa->pool->workerLoop(wa->id);
+        return nullptr;
+    }
+
+    void workerLoop(int id) {
+        while (true) {
+            pthread_mutex_lock(&stateLock);
+            while (pinned[id].empty() && shared.empty() && !shuttingDown) {
+                pthread_cond_wait(&workReady, &stateLock);
+            }
+            if (pinned[id].empty() && shared.empty()) {
+                pthread_mutex_unlock(&stateLock);
+                return;
+            }
+            std::deque<Task>& queue = pinned[id].empty() ? shared : pinned[id];
+            Task t = queue.front();
+            queue.pop_front();
+            pthread_mutex_unlock(&stateLock);
+
+            t.state->complete(t.fn(t.arg));
+        }
+    }
+
+    TaskFuture enqueue(std::deque<Task>& queue, PoolTask fn, void* arg) {
+        Task t = {fn, arg, std::make_shared<TaskState>()};
+        pthread_mutex_lock(&stateLock);
+        queue.push_back(t);
+        pthread_cond_broadcast(&workReady);
+        pthread_mutex_unlock(&stateLock);
+        return TaskFuture(t.state);
+    }
+
+    static void* regionEntry(void* arg) {
+        RegionSlot* slot = (RegionSlot*)arg;
+        ThreadPool* pool = slot->pool;
+        // cada uno toma sus propios tiempos: con menos nucleos que threads el
+        // primero en salir de la barrera puede hacer todo antes de que corra
+        // el worker 0
+        pool->barrier.wait(slot->id);
+        slot->start = bench_ahora();
+        slot->result = slot->fn(slot->arg);
+        slot->finish = bench_ahora();
+        return nullptr;
+    }
+
+public:
+    ThreadPool(int workers) : numWorkers(workers), threads(workers), args(workers),
+                              pinned(workers), shuttingDown(false), barrier(workers),
+                              regionSpan(0.0), regionBusy(workers, 0.0) {
+        pthread_mutex_init(&stateLock, nullptr);
+        pthread_cond_init(&workReady, nullptr);
+
+        for (int i = 0; i < numWorkers; i++) {
+            args[i].pool = this;
+            args[i].id = i;
+            pthread_create(&threads[i], nullptr, workerEntry, &args[i]);
+        }
+    }
+
+    // Termina las tareas pendientes y une los workers
+    ~ThreadPool() {
+        pthread_mutex_lock(&stateLock);
+        shuttingDown = true;
+        pthread_cond_broadcast(&workReady);
+        pthread_mutex_unlock(&stateLock);
+
+        for (int i = 0; i < numWorkers; i++) {
+            pthread_join(threads[i], nullptr);
+        }
+
+        pthread_cond_destroy(&workReady);
+        pthread_mutex_destroy(&stateLock);
+    }
+
+    int size() const { return numWorkers; }
+
+    // Restringe el worker a una sola CPU (afinidad en affinity.h)
+    bool pinWorker(int worker, int cpu) {
+        return Affinity::pinThread(threads[worker], cpu);
+    }
+
+    TaskFuture submit(PoolTask fn, void* arg) {
+        return enqueue(shared, fn, arg);
+    }
+
+    TaskFuture submitTo(int worker, PoolTask fn, void* arg) {
+        if (worker < 0 || worker >= numWorkers) {
+            fprintf(stderr, "submitTo: worker %d en un pool de %d workers\n", worker, numWorkers);
+            exit(EXIT_FAILURE);
+        }
+        return enqueue(pinned[worker], fn, arg);
+    }
+
+    // fn(taskArgs[i]) en los workers 0..count-1 a la vez (1 <= count <= size()).
+    // results[i] recibe lo que devolvio cada llamada si no es nullptr.
+    // Fuera de ese rango se corta el programa: con mas tareas que workers dos
+    // quedarian en la misma cola y la barrera de arranque no se abriria nunca.
+    double runParallel(int count, PoolTask fn, void* const* taskArgs, void** results = nullptr) {
+        if (count < 1 || count > numWorkers) {
+            fprintf(stderr, "runParallel: %d tareas para un pool de %d workers\n", count, numWorkers);
+            exit(EXIT_FAILURE);
+        }
+        std::vector<RegionSlot> slots(count);
+        std::vector<TaskFuture> futures(count);
+        barrier.reset(count);
+
+        for (int i = 0; i < count; i++) {
+            slots[i] = {this, i, fn, taskArgs[i], nullptr, 0.0, 0.0};
+            futures[i] = submitTo(i, regionEntry, &slots[i]);
+        }
+        double first = 0.0, last = 0.0;
+        for (int i = 0; i < count; i++) {
+            futures[i].get();
+            if (results != nullptr) results[i] = slots[i].result;
+            if (i == 0 || slots[i].start < first) first = slots[i].start;
+            if (i == 0 || slots[i].finish > last) last = slots[i].finish;
+            regionBusy[i] = slots[i].finish - slots[i].start;
+        }
+        regionSpan = last - first;
+        return regionSpan;
+    }
+
+    double lastRegionSpan() const { return regionSpan; }
+    double lastRegionBusy(int worker) const { return regionBusy[worker]; }
+};
+
+#endif
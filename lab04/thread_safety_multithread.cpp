@@ -1,7 +1,6 @@
 #include <iostream>
 #include <pthread.h>
 #include <semaphore.h>
-#include <chrono>
 #include <string>
 #include <cstring>
 #include <cstdlib>
@@ -9,8 +8,10 @@
 #include <fstream>
 #include <vector>
 
+#include "../comun/benchmark.h"
+#include "thread_pool.h"
+
 using namespace std;
-using namespace std::chrono;
 
 const int BUFFER_SIZE = 1000;
 const int TOKEN_LIMIT = 100;
@@ -112,6 +113,16 @@ public:
         sem_post(&semaphores[0]);
     }
     
+    // Devuelve el turno al worker 0; al terminar una corrida el turno queda
+    // en el semaforo del worker que siguio al ultimo en leer EOF
+    void reset() {
+        for (int i = 0; i < numSemaphores; i++) {
+            sem_destroy(&semaphores[i]);
+            sem_init(&semaphores[i], 0, 0);
+        }
+        sem_post(&semaphores[0]);
+    }
+    
     ~SemaphoreCoordinator() {
         for (int i = 0; i < numSemaphores; i++) {
             sem_destroy(&semaphores[i]);
@@ -158,6 +169,7 @@ public:
         : fileMgr(fm), stats(st), workerCount(wc) {}
     
     virtual void* execute(int workerId) = 0;
+    virtual void prepare() {}
     virtual ~TokenizationStrategy() {}
 };
 
@@ -170,6 +182,10 @@ public:
     SemaphoreStrategy(FileManager* fm, Statistics* st, int wc, SemaphoreCoordinator* coord)
         : TokenizationStrategy(fm, st, wc), coordinator(coord) {}
     
+    void prepare() override {
+        coordinator->reset();
+    }
+    
     void* execute(int workerId) override {
         char lineBuffer[BUFFER_SIZE];
         int linesProcessed = 0;
@@ -303,46 +319,64 @@ private:
     FileManager* fileMgr;
     Statistics* stats;
     int workerCount;
+    const bench_config* config;
+    ThreadPool pool;
+    
+    struct SampleContext {
+        BenchmarkExecutor* executor;
+        TokenizationStrategy* strategy;
+    };
+    
+    static double sample(void* arg) {
+        SampleContext* ctx = (SampleContext*)arg;
+        return ctx->executor->runOnce(ctx->strategy);
+    }
     
 public:
-    BenchmarkExecutor(FileManager* fm, Statistics* st, int wc)
-        : fileMgr(fm), stats(st), workerCount(wc) {}
+    BenchmarkExecutor(FileManager* fm, Statistics* st, int wc, const bench_config* cfg)
+        : fileMgr(fm), stats(st), workerCount(wc), config(cfg), pool(wc) {
+        Affinity::pinPool(pool);
+    }
     
-    double runBenchmark(TokenizationStrategy* strategy, const char* strategyName) {
-        pthread_t* workers = new pthread_t[workerCount];
-        WorkerResult* results[workerCount];
+    // Una corrida completa sobre el archivo; los workers del pool ya existen y
+    // se mide entre las barreras de arranque y fin (todos corren a la vez,
+    // como necesita el turno circular de SemaphoreStrategy)
+    double runOnce(TokenizationStrategy* strategy) {
+        vector<void*> results(workerCount);
+        vector<void*> args(workerCount);
         WorkerContext* contexts = new WorkerContext[workerCount];
         
         stats->reset();
         fileMgr->openFile("test_input.txt");
+        strategy->prepare();
         
         for (int i = 0; i < workerCount; i++) {
             contexts[i].id = i;
             contexts[i].strategy = strategy;
+            args[i] = &contexts[i];
         }
         
-        auto startTime = high_resolution_clock::now();
+        double elapsed = pool.runParallel(workerCount, workerThreadFunction, args.data(), results.data());
         
         for (int i = 0; i < workerCount; i++) {
-            pthread_create(&workers[i], nullptr, workerThreadFunction, &contexts[i]);
+            delete (WorkerResult*)results[i];
         }
-        
-        for (int i = 0; i < workerCount; i++) {
-            pthread_join(workers[i], (void**)&results[i]);
-        }
-        
-        auto endTime = high_resolution_clock::now();
-        auto elapsed = duration_cast<microseconds>(endTime - startTime);
-        
-        displayResults(strategyName, elapsed.count() / 1000.0);
-        
-        for (int i = 0; i < workerCount; i++) {
-            delete results[i];
-        }
-        delete[] workers;
         delete[] contexts;
         
-        return elapsed.count() / 1000000.0;
+        return elapsed;
+    }
+    
+    // Repite la corrida segun BENCH_WARMUP / BENCH_REPS; lineas y tokens son
+    // los de la ultima repeticion
+    bench_stats runBenchmark(TokenizationStrategy* strategy, const char* strategyName,
+                             const char* recordName) {
+        char name[BENCH_MAX_NOMBRE];
+        snprintf(name, sizeof(name), "tokens/%s/t=%d", recordName, workerCount);
+        SampleContext ctx = {this, strategy};
+        bench_stats result = bench_repetir(name, config, sample, &ctx);
+        
+        displayResults(strategyName, result.mediana * 1000.0);
+        return result;
     }
     
     void displayResults(const char* name, double timeMs) {
@@ -359,6 +393,7 @@ public:
     void showHeader(int workers, int lines) {
         cout << "\n=== analisis de thread safety - tokenizacion de strings ===" << endl;
         cout << "threads: " << workers << ", lineas de entrada: " << lines << endl;
+        cout << "afinidad (LAB04_AFINIDAD): " << Affinity::policyName() << endl;
         cout << "comparacion de implementaciones thread-safe vs unsafe" << endl;
         cout << "\n";
         
@@ -368,8 +403,9 @@ public:
         cout << "|--------------------------|---------|---------|---------|" << endl;
     }
     
-    void showFooter() {
+    void showFooter(const bench_config* cfg) {
         cout << "      =================" << endl;
+        cout << "tiempo = mediana de " << cfg->repeticiones << " repeticiones" << endl;
         cout << "\nanalisis de resultados:" << endl;
         cout << "- implementaciones thread-safe garantizan resultados correctos" << endl;
         cout << "- implementacion unsafe puede mostrar race conditions" << endl;
@@ -392,7 +428,12 @@ int main(int argc, char* argv[]) {
     
     int workerCount = strtol(argv[1], nullptr, 10);
     int lineCount = strtol(argv[2], nullptr, 10);
+    if (workerCount < 1 || lineCount < 0) {
+        cout << "num_threads debe ser >= 1 y num_lineas >= 0" << endl;
+        return 1;
+    }
     
+    bench_config cfg = bench_config_entorno();
     ResultPresenter presenter;
     presenter.showHeader(workerCount, lineCount);
     
@@ -402,17 +443,23 @@ int main(int argc, char* argv[]) {
     FileManager fileMgr;
     Statistics stats;
     SemaphoreCoordinator coordinator(workerCount);
-    BenchmarkExecutor executor(&fileMgr, &stats, workerCount);
+    BenchmarkExecutor executor(&fileMgr, &stats, workerCount, &cfg);
     
     SemaphoreStrategy semStrategy(&fileMgr, &stats, workerCount, &coordinator);
     MutexStrategy mutexStrategy(&fileMgr, &stats, workerCount);
     UnsafeStrategy unsafeStrategy(&fileMgr, &stats, workerCount);
     
-    executor.runBenchmark(&semStrategy, "Con Semaforos");
-    executor.runBenchmark(&mutexStrategy, "Con Mutex");
-    executor.runBenchmark(&unsafeStrategy, "Sin Sincronizacion");
+    bench_stats records[3];
+    records[0] = executor.runBenchmark(&semStrategy, "Con Semaforos", "semaforos");
+    records[1] = executor.runBenchmark(&mutexStrategy, "Con Mutex", "mutex");
+    records[2] = executor.runBenchmark(&unsafeStrategy, "Sin Sincronizacion", "sin_sincronizacion");
     
-    presenter.showFooter();
+    presenter.showFooter(&cfg);
+    
+    for (int i = 0; i < 3; i++) {
+        bench_registrar(&cfg, &records[i]);
+    }
+    bench_config_cerrar(&cfg);
     
     return 0;
 }